@@ -0,0 +1,624 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "ansi_color_codes.h"
+#include "list_arena.h"
+#include "list_log.h"
+#include "my_content.h"
+
+/**
+ * @brief Example of a doubly linked-list kept in one array.
+ * The nodes are the slots of a single growable array and link each
+ * other by slot number (32 bits) instead of by pointer. A node is 16
+ * bytes: two links and the content pointer, with no malloc header,
+ * against 24 bytes plus the malloc header (32 in all) for my_dll.
+ * Walking the list goes through one block of memory, in slot order
+ * for a list that was built by appending.
+ *
+ * A node is known by its handle, the slot number, which stays valid
+ * when the array grows (the array may move, the slot numbers do not).
+ * Freed slots go on a free list inside the array and are used again
+ * first.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+typedef uint32_t adll_handle;
+
+#define ADLL_NIL UINT32_MAX
+#define ADLL_MIN_CAPACITY 16
+
+typedef struct adll_node {
+    adll_handle prev;
+    adll_handle next;       // for a free slot: the next free slot
+    my_content* content;
+} adll_node;
+
+/**
+ * @brief The list handle. used is the number of slots ever handed out;
+ * the slots before it are either in the list or on the free list.
+ * When arena is set, it holds the contents made by adll_from_array;
+ * they are freed all at once with the arena.
+ *
+ */
+typedef struct adll_list {
+    adll_node* nodes;
+    uint32_t capacity;
+    uint32_t used;
+    adll_handle free_head;
+    adll_handle head;
+    adll_handle tail;
+    size_t count;
+    list_arena* arena;
+} adll_list;
+
+/**
+ * @brief the node of a handle. The pointer is good until the next node
+ * is made (the array may grow); the handle stays good until the node is
+ * freed.
+ *
+ * @param list
+ * @param node
+ * @return adll_node*
+ */
+static inline adll_node* adll_at(adll_list* list, adll_handle node) {
+    return &list->nodes[node];
+}
+
+static inline adll_handle adll_next(adll_list* list, adll_handle node) {
+    return list->nodes[node].next;
+}
+
+static inline adll_handle adll_prev(adll_list* list, adll_handle node) {
+    return list->nodes[node].prev;
+}
+
+/**
+ * @brief growing the array to hold at least `capacity` slots.
+ *
+ */
+static list_status adll_reserve(adll_list* list, uint32_t capacity) {
+    if (capacity <= list->capacity) {
+        return LIST_OK;
+    }
+    uint32_t new_capacity = list->capacity > 0 ? list->capacity : ADLL_MIN_CAPACITY;
+    while (new_capacity < capacity) {
+        new_capacity = new_capacity <= (ADLL_NIL - 1) / 2 ? new_capacity * 2 : ADLL_NIL - 1;
+    }
+    adll_node* nodes = realloc(list->nodes, (size_t)new_capacity * sizeof(adll_node));
+    if (nodes == NULL) {
+        return LIST_ERR_NO_MEMORY;
+    }
+    list->nodes = nodes;
+    list->capacity = new_capacity;
+    return LIST_OK;
+}
+
+/**
+ * @brief making a node with a given content, not linked yet. The slot
+ * comes from the free list when there is one, else from the end of the
+ * array, which grows when full.
+ *
+ * @param list
+ * @param content
+ * @return adll_handle ADLL_NIL when content is NULL or no slot is left.
+ */
+adll_handle adll_make_node(adll_list* list, my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list and/or content is NULL!\n");
+        return ADLL_NIL;
+    }
+
+    adll_handle node = list->free_head;
+    if (node != ADLL_NIL) {
+        list->free_head = list->nodes[node].next;
+    } else {
+        if (list->used == ADLL_NIL - 1 || adll_reserve(list, list->used + 1) != LIST_OK) {
+            LOG_ERROR("no slot left!\n");
+            return ADLL_NIL;
+        }
+        node = list->used++;
+    }
+    list->nodes[node].prev = ADLL_NIL;
+    list->nodes[node].next = ADLL_NIL;
+    list->nodes[node].content = content;
+    return node;
+}
+
+/**
+ * @brief freeing a node that is not in the list, including its
+ * content; the slot goes on the free list.
+ *
+ * @param list
+ * @param node
+ * @return adll_handle ADLL_NIL
+ */
+adll_handle adll_free_node(adll_list* list, adll_handle node) {
+    if (list == NULL || node >= list->used) {
+        LOG_ERROR("list is NULL or node is not a node of the list!\n");
+        return ADLL_NIL;
+    }
+
+    LOG_DEBUG("freeing adll node ...\n");
+    adll_node* slot = &list->nodes[node];
+    if (!list_arena_owns(list->arena, slot->content)) {
+        content_free(slot->content);
+    }
+    slot->content = NULL;
+    slot->prev = ADLL_NIL;
+    slot->next = list->free_head;
+    list->free_head = node;
+    return ADLL_NIL;
+}
+
+/**
+ * @brief making an empty list with room for `capacity` nodes.
+ *
+ * @param capacity
+ * @return adll_list*
+ */
+adll_list* adll_make_empty(uint32_t capacity) {
+    adll_list* list = malloc(sizeof(adll_list));
+    list->nodes = NULL;
+    list->capacity = 0;
+    list->used = 0;
+    list->free_head = ADLL_NIL;
+    list->head = ADLL_NIL;
+    list->tail = ADLL_NIL;
+    list->count = 0;
+    list->arena = NULL;
+    if (capacity > 0 && adll_reserve(list, capacity) != LIST_OK) {
+        free(list);
+        return NULL;
+    }
+    return list;
+}
+
+/**
+ * @brief Making the list with a first node.
+ *
+ * @cond content cannot be NULL.
+ *
+ * @param content
+ * @return adll_list*
+ */
+adll_list* adll_make_list(my_content* content) {
+    if (content == NULL) {
+        LOG_ERROR("content is NULL!\n");
+        return NULL;
+    }
+
+    adll_list* list = adll_make_empty(0);
+    adll_handle node = adll_make_node(list, content);
+    list->head = node;
+    list->tail = node;
+    list->count = 1;
+    return list;
+}
+
+/**
+ * @brief Making the list from an array of texts: the array gets its
+ * size once and the contents come from one arena owned by the list.
+ *
+ * @cond texts and every text in it cannot be NULL. count may be 0.
+ *
+ * @param texts
+ * @param count
+ * @return adll_list*
+ */
+adll_list* adll_from_array(const char* const* texts, size_t count) {
+    if ((texts == NULL && count > 0) || count >= ADLL_NIL) {
+        LOG_ERROR("texts is NULL or count is too large!\n");
+        return NULL;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (texts[i] == NULL) {
+            LOG_ERROR("text %zu is NULL!\n", i);
+            return NULL;
+        }
+        total += list_pool_align(CONTENT_SIZE(strlen(texts[i])));
+    }
+
+    adll_list* list = adll_make_empty(count);
+    if (list == NULL) {
+        return NULL;
+    }
+    list->arena = count > 0 ? list_arena_make(total) : NULL;
+    for (size_t i = 0; i < count; i++) {
+        size_t length = strlen(texts[i]);
+        adll_node* node = &list->nodes[i];
+        node->content = content_init(list_arena_alloc(list->arena, CONTENT_SIZE(length)), texts[i], length);
+        node->prev = i > 0 ? (adll_handle)(i - 1) : ADLL_NIL;
+        node->next = i + 1 < count ? (adll_handle)(i + 1) : ADLL_NIL;
+    }
+    list->used = count;
+    list->count = count;
+    list->head = count > 0 ? 0 : ADLL_NIL;
+    list->tail = count > 0 ? (adll_handle)(count - 1) : ADLL_NIL;
+    return list;
+}
+
+/**
+ * @brief Adding a node at the end of the list.
+ *
+ * @param list
+ * @param node
+ * @return list_status
+ */
+list_status adll_append_node(adll_list* list, adll_handle node) {
+    if (list == NULL || node == ADLL_NIL) {
+        LOG_ERROR("list and/or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    adll_node* slot = &list->nodes[node];
+    slot->next = ADLL_NIL;
+    slot->prev = list->tail;
+    if (list->tail == ADLL_NIL) {
+        list->head = node;
+    } else {
+        list->nodes[list->tail].next = node;
+    }
+    list->tail = node;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief Adding a node in front of the list.
+ *
+ * @param list
+ * @param node
+ * @return list_status
+ */
+list_status adll_prepend_node(adll_list* list, adll_handle node) {
+    if (list == NULL || node == ADLL_NIL) {
+        LOG_ERROR("list and/or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    adll_node* slot = &list->nodes[node];
+    slot->prev = ADLL_NIL;
+    slot->next = list->head;
+    if (list->head == ADLL_NIL) {
+        list->tail = node;
+    } else {
+        list->nodes[list->head].prev = node;
+    }
+    list->head = node;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief Inserting a node in front of `at`.
+ *
+ * @cond at must be in the list. An empty list gives LIST_ERR_NOT_FOUND.
+ *
+ * @param list
+ * @param at
+ * @param node
+ * @return list_status
+ */
+list_status adll_insert_node(adll_list* list, adll_handle at, adll_handle node) {
+    if (list == NULL || at == ADLL_NIL || node == ADLL_NIL) {
+        LOG_ERROR("list or at or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->head == ADLL_NIL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+    if (at == list->head) {
+        return adll_prepend_node(list, node);
+    }
+
+    adll_node* slot = &list->nodes[node];
+    adll_node* at_slot = &list->nodes[at];
+    slot->next = at;
+    slot->prev = at_slot->prev;
+    list->nodes[at_slot->prev].next = node;
+    at_slot->prev = node;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief Removing a node from the list (DONOT FREE THE NODE)
+ *
+ * @cond at must be in the list. An empty list gives LIST_ERR_NOT_FOUND.
+ *
+ * @param list
+ * @param at
+ * @return list_status
+ */
+list_status adll_remove_node(adll_list* list, adll_handle at) {
+    if (list == NULL || at == ADLL_NIL) {
+        LOG_ERROR("list and/or at is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->head == ADLL_NIL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+
+    adll_node* slot = &list->nodes[at];
+    if (at == list->head) {
+        list->head = slot->next;
+    } else {
+        list->nodes[slot->prev].next = slot->next;
+    }
+    if (at == list->tail) {
+        list->tail = slot->prev;
+    } else {
+        list->nodes[slot->next].prev = slot->prev;
+    }
+    slot->prev = ADLL_NIL;
+    slot->next = ADLL_NIL;
+    list->count--;
+    return LIST_OK;
+}
+
+size_t adll_size(adll_list* list) {
+    return list != NULL ? list->count : 0;
+}
+
+adll_handle adll_get_last_node(adll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return ADLL_NIL;
+    }
+    return list->tail;
+}
+
+/**
+ * @brief Searching for the first node with a given content.
+ *
+ * @param list
+ * @param content
+ * @return adll_handle ADLL_NIL when there is none.
+ */
+adll_handle adll_search_node(adll_list* list, my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_DEBUG("list is empty!\n");
+        return ADLL_NIL;
+    }
+
+    adll_node* nodes = list->nodes;
+    adll_handle cur = list->head;
+    while (cur != ADLL_NIL && !content_equals(nodes[cur].content, content)) {
+        cur = nodes[cur].next;
+    }
+    return cur;
+}
+
+/**
+ * @brief printing the contents of the list
+ *
+ * @param list
+ */
+void adll_print_list(adll_list* list) {
+    if (list == NULL || list->head == ADLL_NIL) {
+        printf(">>> list is empty!\n");
+        return;
+    }
+
+    size_t node_no = 1;
+    for (adll_handle cur = list->head; cur != ADLL_NIL; cur = list->nodes[cur].next) {
+        printf("%zu. %s\n", node_no++, list->nodes[cur].content->text);
+    }
+    printf(">>> list size: %zu\n", list->count);
+}
+
+/**
+ * @brief print the contents of the list in a reverse order, starting
+ * from the tail.
+ *
+ * @param list
+ */
+void adll_print_list_reverse(adll_list* list) {
+    if (list == NULL || list->head == ADLL_NIL) {
+        printf("list is empty!\n");
+        return;
+    }
+
+    printf("%sprinting list in reverse order...%s\n", YEL, reset);
+    size_t count = list->count;
+    for (adll_handle cur = list->tail; cur != ADLL_NIL; cur = list->nodes[cur].prev) {
+        printf("%zu. %s\n", count--, list->nodes[cur].content->text);
+    }
+    printf(">>> list size: %zu\n", list->count);
+}
+
+/**
+ * @brief Removing and freeing all the nodes and their contents. The
+ * array is kept for the nodes to come; the list is empty afterwards.
+ *
+ * @param list
+ * @return list_status
+ */
+list_status adll_clear_list(adll_list* list) {
+    if (list == NULL) {
+        return LIST_ERR_NULL;
+    }
+
+    for (adll_handle cur = list->head; cur != ADLL_NIL; cur = list->nodes[cur].next) {
+        if (!list_arena_owns(list->arena, list->nodes[cur].content)) {
+            content_free(list->nodes[cur].content);
+        }
+    }
+    list->used = 0;
+    list->free_head = ADLL_NIL;
+    list->head = ADLL_NIL;
+    list->tail = ADLL_NIL;
+    list->count = 0;
+    list->arena = list_arena_free(list->arena);
+    return LIST_OK;
+}
+
+/**
+ * @brief Removing all the nodes and the list handle. return NULL when
+ * complete.
+ *
+ * @param list
+ * @return adll_list*
+ */
+adll_list* adll_remove_list(adll_list* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+
+    adll_clear_list(list);
+    free(list->nodes);
+    free(list);
+    return NULL;
+}
+
+// ****** TEST CODE ****** //
+// Define ADLL_NO_MAIN to use the functions above from another program.
+#ifndef ADLL_NO_MAIN
+
+const char* test_str_node_0_5 = "*** Node 0.5 ***";
+const char* test_str_node_1_0 = "*** Node 1.0 ***";
+const char* test_str_node_1_5 = "*** Node 1.5 ***";
+const char* test_str_node_2_0 = "*** Node 2.0 ***";
+const char* test_str_node_3_0 = "*** Node 3.0 ***";
+
+/**
+ * @brief the texts of the list, checked in both directions.
+ *
+ */
+void test_check_texts(adll_list* list, const char* const* texts, size_t count) {
+    assert(adll_size(list) == count);
+    size_t i = 0;
+    for (adll_handle cur = list->head; cur != ADLL_NIL; cur = adll_next(list, cur)) {
+        assert(strcmp(adll_at(list, cur)->content->text, texts[i++]) == 0);
+    }
+    assert(i == count);
+    for (adll_handle cur = list->tail; cur != ADLL_NIL; cur = adll_prev(list, cur)) {
+        assert(strcmp(adll_at(list, cur)->content->text, texts[--i]) == 0);
+    }
+}
+
+void test_making_and_appending() {
+    printf("%s\ntest_making_and_appending%s\n", GRN, reset);
+    adll_list* list = adll_make_list(content_make(test_str_node_1_0));
+    list_status status = adll_append_node(list, adll_make_node(list, content_make(test_str_node_2_0)));
+    assert(status == LIST_OK);
+    status = adll_append_node(list, adll_make_node(list, content_make(test_str_node_3_0)));
+    assert(status == LIST_OK);
+    status = adll_prepend_node(list, adll_make_node(list, content_make(test_str_node_0_5)));
+    assert(status == LIST_OK);
+    test_check_texts(list, (const char*[]){ test_str_node_0_5, test_str_node_1_0, test_str_node_2_0,
+        test_str_node_3_0 }, 4);
+    adll_print_list(list);
+    adll_print_list_reverse(list);
+
+    printf("*** handles stay good while the array grows\n");
+    adll_handle last = adll_get_last_node(list);
+    char buf[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "*** Node %d ***", 4 + i);
+        adll_append_node(list, adll_make_node(list, content_make(buf)));
+    }
+    assert(list->capacity >= 1004);
+    assert(strcmp(adll_at(list, last)->content->text, test_str_node_3_0) == 0);
+    assert(adll_size(list) == 1004);
+    list = adll_remove_list(list);
+    assert(list == NULL);
+}
+
+void test_inserting_and_removing() {
+    printf("%s\ntest_inserting_and_removing%s\n", GRN, reset);
+    const char* texts[] = { test_str_node_1_0, test_str_node_2_0, test_str_node_3_0 };
+    adll_list* list = adll_from_array(texts, 3);
+    test_check_texts(list, texts, 3);
+
+    my_content* search_content = content_make(test_str_node_2_0);
+    adll_handle at = adll_search_node(list, search_content);
+    assert(at == 1);
+    list_status status = adll_insert_node(list, at, adll_make_node(list, content_make(test_str_node_1_5)));
+    assert(status == LIST_OK);
+    status = adll_insert_node(list, list->head, adll_make_node(list, content_make(test_str_node_0_5)));
+    assert(status == LIST_OK);
+    test_check_texts(list, (const char*[]){ test_str_node_0_5, test_str_node_1_0, test_str_node_1_5,
+        test_str_node_2_0, test_str_node_3_0 }, 5);
+    adll_print_list(list);
+
+    printf("*** removing the middle, the head and the tail\n");
+    status = adll_remove_node(list, at);
+    assert(status == LIST_OK);
+    adll_free_node(list, at);
+    assert(adll_search_node(list, search_content) == ADLL_NIL);
+    adll_handle head = list->head;
+    adll_remove_node(list, head);
+    adll_free_node(list, head);
+    adll_handle tail = list->tail;
+    adll_remove_node(list, tail);
+    adll_free_node(list, tail);
+    test_check_texts(list, (const char*[]){ test_str_node_1_0, test_str_node_1_5 }, 2);
+    adll_print_list_reverse(list);
+
+    printf("*** freed slots are used again, the array does not grow\n");
+    uint32_t used = list->used;
+    adll_handle node = adll_make_node(list, content_make(test_str_node_3_0));
+    assert(node == tail);
+    adll_append_node(list, node);
+    adll_append_node(list, adll_make_node(list, content_make(test_str_node_3_0)));
+    adll_append_node(list, adll_make_node(list, content_make(test_str_node_3_0)));
+    assert(list->used == used);
+    assert(adll_size(list) == 5);
+
+    printf("*** clearing keeps the array\n");
+    uint32_t capacity = list->capacity;
+    status = adll_clear_list(list);
+    assert(status == LIST_OK);
+    assert(adll_size(list) == 0 && list->head == ADLL_NIL && list->capacity == capacity);
+    assert(adll_search_node(list, search_content) == ADLL_NIL);
+    adll_print_list(list);
+    content_free(search_content);
+    list = adll_remove_list(list);
+}
+
+void test_status_codes() {
+    printf("%s\ntest_status_codes%s\n", GRN, reset);
+    adll_list* list = adll_make_empty(0);
+    adll_handle node = adll_make_node(list, content_make(test_str_node_1_0));
+    list_status status = adll_insert_node(list, node, node);
+    assert(status == LIST_ERR_NOT_FOUND);
+    status = adll_remove_node(list, node);
+    assert(status == LIST_ERR_NOT_FOUND);
+    status = adll_append_node(NULL, node);
+    assert(status == LIST_ERR_NULL);
+    status = adll_append_node(list, ADLL_NIL);
+    assert(status == LIST_ERR_NULL);
+    assert(adll_make_node(list, NULL) == ADLL_NIL);
+    assert(adll_make_list(NULL) == NULL);
+    assert(adll_from_array((const char*[]){ test_str_node_1_0, NULL }, 2) == NULL);
+    status = adll_append_node(list, node);
+    assert(status == LIST_OK);
+    list = adll_remove_list(list);
+    list = adll_from_array(NULL, 0);
+    assert(adll_size(list) == 0);
+    list = adll_remove_list(list);
+}
+
+/**
+ * @brief running test code for using functions above.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char* argv[]) {
+    printf("%s---> STARTS!%s\n", RED, reset);
+    printf("node size: %zu bytes\n", sizeof(adll_node));
+    test_making_and_appending();
+    test_inserting_and_removing();
+    test_status_codes();
+    printf("%s\n---> ENDS!%s\n", RED, reset);
+    return 0;
+}
+#endif
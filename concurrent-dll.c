@@ -0,0 +1,535 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <pthread.h>
+#include "list_log.h"
+#include "my_content.h"
+
+/**
+ * @brief Example of a thread-safe doubly linked-list with a lock in
+ * every node.
+ * The list is a sorted set of contents. Threads walk it hand over hand
+ * (lock coupling): the lock of the next node is taken before the lock
+ * of the current one is let go, always from head to tail. Readers take
+ * the node locks shared, so any number of them walk together; writers
+ * take them exclusively, but only hold two or three neighboring nodes
+ * at a time, so writers in different parts of the list do not wait for
+ * each other.
+ *
+ * Because no thread can reach a node without holding its predecessor,
+ * a removed node can be freed right away; no reclamation scheme is
+ * needed.
+ *
+ * The list is only walked forward while threads use it;
+ * cdll_print_list_reverse is for a list at rest.
+ *
+ * Build with -pthread.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+/**
+ * @brief A reader-writer spin lock in one word: the top bit is the
+ * writer, the next one a writer waiting, the rest counts the readers.
+ * A waiting writer keeps new readers out, so the readers drain and a
+ * steady stream of them cannot hold the writer off. Waiting threads
+ * yield the CPU after a few tries.
+ *
+ */
+typedef struct cdll_lock {
+    atomic_uint state;
+} cdll_lock;
+
+#define CDLL_WRITER 0x80000000u
+#define CDLL_PENDING 0x40000000u
+#define CDLL_SPINS 64
+
+static inline void cdll_pause(unsigned int* spins) {
+    if (++*spins >= CDLL_SPINS) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+static inline void cdll_read_lock(cdll_lock* lock) {
+    unsigned int spins = 0;
+    for (;;) {
+        unsigned int state = atomic_load_explicit(&lock->state, memory_order_relaxed);
+        if (!(state & (CDLL_WRITER | CDLL_PENDING)) &&
+                atomic_compare_exchange_weak_explicit(&lock->state, &state, state + 1,
+                    memory_order_acquire, memory_order_relaxed)) {
+            return;
+        }
+        cdll_pause(&spins);
+    }
+}
+
+static inline void cdll_read_unlock(cdll_lock* lock) {
+    atomic_fetch_sub_explicit(&lock->state, 1, memory_order_release);
+}
+
+static inline void cdll_write_lock(cdll_lock* lock) {
+    unsigned int spins = 0;
+    for (;;) {
+        unsigned int state = atomic_load_explicit(&lock->state, memory_order_relaxed);
+        if ((state & ~CDLL_PENDING) == 0) {
+            // taking the lock clears the waiting bit; other waiting
+            // writers set it again.
+            if (atomic_compare_exchange_weak_explicit(&lock->state, &state, CDLL_WRITER,
+                    memory_order_acquire, memory_order_relaxed)) {
+                return;
+            }
+        } else if (!(state & CDLL_PENDING)) {
+            atomic_fetch_or_explicit(&lock->state, CDLL_PENDING, memory_order_relaxed);
+        }
+        cdll_pause(&spins);
+    }
+}
+
+static inline void cdll_write_unlock(cdll_lock* lock) {
+    // keeping the waiting bit another writer may have set meanwhile.
+    atomic_fetch_and_explicit(&lock->state, ~CDLL_WRITER, memory_order_release);
+}
+
+/**
+ * @brief The node carries its content right behind it, like the text
+ * nodes of my_dll. The head and tail sentinels have no content.
+ *
+ */
+typedef struct cdll {
+    struct cdll* prev_ptr;
+    struct cdll* next_ptr;
+    cdll_lock lock;
+    my_content* content;
+} cdll;
+
+typedef struct cdll_list {
+    cdll head;
+    cdll tail;
+    atomic_size_t count;
+} cdll_list;
+
+/**
+ * @brief ordering of a node against a content; the sentinels are below
+ * and above everything.
+ *
+ */
+static inline int cdll_compare(cdll_list* list, cdll* node, const my_content* content) {
+    if (node == &list->tail) {
+        return 1;
+    }
+    return content_compare(node->content, content);
+}
+
+/**
+ * @brief making an empty list.
+ *
+ * @return cdll_list*
+ */
+cdll_list* cdll_make_list() {
+    cdll_list* list = malloc(sizeof(cdll_list));
+    list->head.prev_ptr = NULL;
+    list->head.next_ptr = &list->tail;
+    list->head.content = NULL;
+    atomic_init(&list->head.lock.state, 0);
+    list->tail.prev_ptr = &list->head;
+    list->tail.next_ptr = NULL;
+    list->tail.content = NULL;
+    atomic_init(&list->tail.lock.state, 0);
+    atomic_init(&list->count, 0);
+    return list;
+}
+
+/**
+ * @brief walking with exclusive locks to the first node not less than
+ * the content. On return `*pred` and the returned node are locked.
+ *
+ */
+static cdll* cdll_find_locked(cdll_list* list, const my_content* content, cdll** pred_out) {
+    cdll* pred = &list->head;
+    cdll_write_lock(&pred->lock);
+    cdll* cur = pred->next_ptr;
+    cdll_write_lock(&cur->lock);
+    while (cdll_compare(list, cur, content) < 0) {
+        cdll_write_unlock(&pred->lock);
+        pred = cur;
+        cur = cur->next_ptr;
+        cdll_write_lock(&cur->lock);
+    }
+    *pred_out = pred;
+    return cur;
+}
+
+/**
+ * @brief adding a text to the set, in order.
+ *
+ * @param list
+ * @param text
+ * @return list_status LIST_ERR_EXISTS when the text is in the set.
+ */
+list_status cdll_insert(cdll_list* list, const char* text) {
+    if (list == NULL || text == NULL) {
+        LOG_ERROR("list and/or text is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    size_t length = strlen(text);
+    cdll* node = malloc(sizeof(cdll) + CONTENT_SIZE(length));
+    if (node == NULL) {
+        return LIST_ERR_NO_MEMORY;
+    }
+    node->content = content_init(node + 1, text, length);
+    atomic_init(&node->lock.state, 0);
+
+    cdll* pred;
+    cdll* cur = cdll_find_locked(list, node->content, &pred);
+    list_status status = LIST_OK;
+    if (cur != &list->tail && content_equals(cur->content, node->content)) {
+        free(node);
+        status = LIST_ERR_EXISTS;
+    } else {
+        // pred and cur are locked, nobody else can see between them.
+        node->prev_ptr = pred;
+        node->next_ptr = cur;
+        pred->next_ptr = node;
+        cur->prev_ptr = node;
+        atomic_fetch_add_explicit(&list->count, 1, memory_order_relaxed);
+    }
+    cdll_write_unlock(&cur->lock);
+    cdll_write_unlock(&pred->lock);
+    return status;
+}
+
+/**
+ * @brief removing a content from the set and freeing its node.
+ *
+ * @param list
+ * @param content
+ * @return list_status LIST_ERR_NOT_FOUND when it is not in the set.
+ */
+list_status cdll_remove(cdll_list* list, const my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list and/or content is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    cdll* pred;
+    cdll* cur = cdll_find_locked(list, content, &pred);
+    if (cur == &list->tail || !content_equals(cur->content, content)) {
+        cdll_write_unlock(&cur->lock);
+        cdll_write_unlock(&pred->lock);
+        return LIST_ERR_NOT_FOUND;
+    }
+
+    // the successor's prev_ptr changes too, so it is locked as well.
+    cdll* succ = cur->next_ptr;
+    cdll_write_lock(&succ->lock);
+    pred->next_ptr = succ;
+    succ->prev_ptr = pred;
+    atomic_fetch_sub_explicit(&list->count, 1, memory_order_relaxed);
+    cdll_write_unlock(&succ->lock);
+    cdll_write_unlock(&cur->lock);
+    cdll_write_unlock(&pred->lock);
+
+    // a thread waiting for cur would hold pred, which we held: nobody does.
+    free(cur);
+    return LIST_OK;
+}
+
+/**
+ * @brief searching for a content, with shared locks so that readers do
+ * not wait for each other.
+ *
+ * @param list
+ * @param content
+ * @return true
+ * @return false
+ */
+bool cdll_contains(cdll_list* list, const my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list and/or content is NULL!\n");
+        return false;
+    }
+
+    cdll* pred = &list->head;
+    cdll_read_lock(&pred->lock);
+    cdll* cur = pred->next_ptr;
+    cdll_read_lock(&cur->lock);
+    cdll_read_unlock(&pred->lock);
+    int order;
+    while ((order = cdll_compare(list, cur, content)) < 0) {
+        cdll* next = cur->next_ptr;
+        cdll_read_lock(&next->lock);
+        cdll_read_unlock(&cur->lock);
+        cur = next;
+    }
+    cdll_read_unlock(&cur->lock);
+    return order == 0;
+}
+
+/**
+ * @brief the number of contents in the set. Exact only when no thread
+ * is changing the list.
+ *
+ * @param list
+ * @return size_t
+ */
+size_t cdll_size(cdll_list* list) {
+    return list != NULL ? atomic_load(&list->count) : 0;
+}
+
+/**
+ * @brief printing the list, walking it the same way as a search.
+ *
+ * @param list
+ */
+void cdll_print_list(cdll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return;
+    }
+
+    cdll* cur = &list->head;
+    cdll_read_lock(&cur->lock);
+    int i = 1;
+    while (cur->next_ptr != &list->tail) {
+        cdll* next = cur->next_ptr;
+        cdll_read_lock(&next->lock);
+        cdll_read_unlock(&cur->lock);
+        cur = next;
+        printf("%d. %s\n", i++, cur->content->text);
+    }
+    cdll_read_unlock(&cur->lock);
+    printf(">>> list size: %zu\n", cdll_size(list));
+}
+
+/**
+ * @brief printing the list from the tail.
+ *
+ * @cond no thread may use the list meanwhile.
+ *
+ * @param list
+ */
+void cdll_print_list_reverse(cdll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return;
+    }
+
+    int i = cdll_size(list);
+    for (cdll* cur = list->tail.prev_ptr; cur != &list->head; cur = cur->prev_ptr) {
+        printf("%d. %s\n", i--, cur->content->text);
+    }
+    printf(">>> list size: %zu\n", cdll_size(list));
+}
+
+/**
+ * @brief freeing the list and its nodes. return NULL when complete.
+ *
+ * @cond no thread may use the list any more.
+ *
+ * @param list
+ * @return cdll_list*
+ */
+cdll_list* cdll_remove_list(cdll_list* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+    cdll* cur = list->head.next_ptr;
+    while (cur != &list->tail) {
+        cdll* next = cur->next_ptr;
+        free(cur);
+        cur = next;
+    }
+    free(list);
+    return NULL;
+}
+
+// ****** TEST CODE ****** //
+// Define CDLL_NO_MAIN to use the functions above from another program.
+#ifndef CDLL_NO_MAIN
+#include "ansi_color_codes.h"
+
+#define TEST_THREADS 4
+#define TEST_KEYS 64
+#define TEST_OPS 100000
+
+/**
+ * @brief checking both directions: sorted forward, prev_ptr mirroring
+ * next_ptr, and the count.
+ *
+ */
+void test_check_list(cdll_list* list) {
+    size_t count = 0;
+    for (cdll* cur = list->head.next_ptr; cur != &list->tail; cur = cur->next_ptr) {
+        assert(cur->next_ptr->prev_ptr == cur);
+        assert(cur->prev_ptr == &list->head || content_compare(cur->prev_ptr->content, cur->content) < 0);
+        assert(atomic_load(&cur->lock.state) == 0);
+        count++;
+    }
+    assert(list->tail.prev_ptr->next_ptr == &list->tail);
+    assert(count == cdll_size(list));
+}
+
+void test_single_thread() {
+    printf("%s\ntest_single_thread%s\n", GRN, reset);
+    cdll_list* list = cdll_make_list();
+    list_status status = cdll_insert(list, "*** Node 2.0 ***");
+    assert(status == LIST_OK);
+    status = cdll_insert(list, "*** Node 3.0 ***");
+    assert(status == LIST_OK);
+    status = cdll_insert(list, "*** Node 1.0 ***");
+    assert(status == LIST_OK);
+    status = cdll_insert(list, "*** Node 2.0 ***");
+    assert(status == LIST_ERR_EXISTS);
+    status = cdll_insert(list, NULL);
+    assert(status == LIST_ERR_NULL);
+    assert(cdll_size(list) == 3);
+    cdll_print_list(list);
+    cdll_print_list_reverse(list);
+    test_check_list(list);
+
+    printf("*** removing the middle, the first and the last node\n");
+    my_content* search_content = content_make("*** Node 2.0 ***");
+    assert(cdll_contains(list, search_content));
+    status = cdll_remove(list, search_content);
+    assert(status == LIST_OK);
+    assert(!cdll_contains(list, search_content));
+    status = cdll_remove(list, search_content);
+    assert(status == LIST_ERR_NOT_FOUND);
+    content_free(search_content);
+    test_check_list(list);
+
+    search_content = content_make("*** Node 1.0 ***");
+    status = cdll_remove(list, search_content);
+    assert(status == LIST_OK);
+    content_free(search_content);
+    search_content = content_make("*** Node 3.0 ***");
+    status = cdll_remove(list, search_content);
+    assert(status == LIST_OK);
+    content_free(search_content);
+    assert(cdll_size(list) == 0 && list->head.next_ptr == &list->tail);
+    test_check_list(list);
+    list = cdll_remove_list(list);
+}
+
+typedef struct test_worker {
+    cdll_list* list;
+    my_content** keys;
+    unsigned long long seed;
+    long net[TEST_KEYS];     // successful inserts minus removes per key
+} test_worker;
+
+void* test_stress_worker(void* arg) {
+    test_worker* worker = arg;
+    unsigned long long seed = worker->seed;
+    for (int i = 0; i < TEST_OPS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t key = seed % TEST_KEYS;
+        switch ((seed >> 32) % 3) {
+        case 0:
+            if (cdll_insert(worker->list, worker->keys[key]->text) == LIST_OK) {
+                worker->net[key]++;
+            }
+            break;
+        case 1:
+            if (cdll_remove(worker->list, worker->keys[key]) == LIST_OK) {
+                worker->net[key]--;
+            }
+            break;
+        default:
+            cdll_contains(worker->list, worker->keys[key]);
+            break;
+        }
+    }
+    return NULL;
+}
+
+void test_stress() {
+    printf("%s\ntest_stress%s\n", GRN, reset);
+    printf("*** %d threads, %d ops each on %d keys\n", TEST_THREADS, TEST_OPS, TEST_KEYS);
+    cdll_list* list = cdll_make_list();
+    my_content* keys[TEST_KEYS];
+    char buf[32];
+    for (int i = 0; i < TEST_KEYS; i++) {
+        snprintf(buf, sizeof(buf), "key-%03d", i);
+        keys[i] = content_make(buf);
+    }
+
+    pthread_t threads[TEST_THREADS];
+    test_worker workers[TEST_THREADS];
+    for (int t = 0; t < TEST_THREADS; t++) {
+        workers[t].list = list;
+        workers[t].keys = keys;
+        workers[t].seed = 2463534242u + t * 7919;
+        memset(workers[t].net, 0, sizeof(workers[t].net));
+        pthread_create(&threads[t], NULL, test_stress_worker, &workers[t]);
+    }
+    for (int t = 0; t < TEST_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    test_check_list(list);
+    size_t present = 0;
+    for (int i = 0; i < TEST_KEYS; i++) {
+        long net = 0;
+        for (int t = 0; t < TEST_THREADS; t++) {
+            net += workers[t].net[i];
+        }
+        assert(net == 0 || net == 1);
+        assert(cdll_contains(list, keys[i]) == (net == 1));
+        present += net;
+        keys[i] = content_free(keys[i]);
+    }
+    assert(cdll_size(list) == present);
+    printf("keys left= %zu\n", present);
+    list = cdll_remove_list(list);
+}
+
+void* test_writer(void* arg) {
+    cdll_lock* lock = arg;
+    cdll_write_lock(lock);
+    cdll_write_unlock(lock);
+    return NULL;
+}
+
+void test_writer_waits() {
+    printf("%s\ntest_writer_waits%s\n", GRN, reset);
+    printf("*** a waiting writer keeps new readers out\n");
+    cdll_lock lock;
+    atomic_init(&lock.state, 0);
+    cdll_read_lock(&lock);
+    pthread_t writer;
+    pthread_create(&writer, NULL, test_writer, &lock);
+    while (!(atomic_load(&lock.state) & CDLL_PENDING)) {
+        sched_yield();
+    }
+    // the reader still holds the lock; a new one would have to wait.
+    assert(atomic_load(&lock.state) == (CDLL_PENDING | 1));
+    cdll_read_unlock(&lock);
+    pthread_join(writer, NULL);
+    assert(atomic_load(&lock.state) == 0);
+}
+
+/**
+ * @brief running test code for using functions above.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char* argv[]) {
+    printf("%s---> STARTS!%s\n", RED, reset);
+    test_single_thread();
+    test_stress();
+    test_writer_waits();
+    printf("%s\n---> ENDS!%s\n", RED, reset);
+    return 0;
+}
+#endif
@@ -3,6 +3,16 @@
 #include <string.h>
 #include <assert.h>
 #include "ansi_color_codes.h"
+#include "list_pool.h"
+#include "list_arena.h"
+#include "list_log.h"
+#include "my_content.h"
+#include "list_index.h"
+#include "list_skip.h"
+#include "list_file.h"
+#include "list_stream.h"
+#include "list_writer.h"
+#include "list_trace.h"
 
 /**
  * @brief Example of a doubly linked-list management.
@@ -17,12 +27,11 @@
 
 /**
  * @brief Data structures for the node and its contents ...
+ * The content (my_content.h) keeps its text inline. A node made with
+ * dll_make_text_node carries its content right behind the node, in
+ * the same allocation.
  * 
  */
-typedef struct my_content{
-    char* text;
-} my_content;
-
 
 typedef struct my_dll {
     struct my_dll* prev_ptr;
@@ -30,301 +39,1263 @@ typedef struct my_dll {
     my_content *content;
 } my_dll;
 
-typedef enum {false, true} bool;
-
 /**
- * @brief making the content with a given text.
+ * @brief The list handle. It keeps track of the first and the last
+ * node so that appending, prepending and getting the last node do
+ * not need to walk the list.
  * 
- * @cond text cannot be NULL
+ * When pool is set, the nodes of the list come from that pool instead
+ * of malloc. When index is set, searching goes through the hash index
+ * instead of walking the list (see dll_attach_index). When arena is
+ * set, it holds the nodes made by dll_from_array; they are freed all
+ * at once with the arena. When skip is set, the list is kept sorted
+ * and ordered lookups go through the skip list (see dll_attach_skip).
+ * When file is set, the contents of the nodes made by dll_load point
+ * into that mapped list file (list_file.h); it is unmapped together
+ * with the arena.
+ * 
+ * When arena_mode is set (dll_make_arena_list), the nodes made for the
+ * list by dll_make_text_node, with their contents, come from the arena
+ * as well. loose counts the nodes in a list with an arena that do not
+ * come from it; when there are none, dll_clear_list / dll_remove_list
+ * release the whole list with the arena's blocks, without walking it.
  * 
- * @param text 
- * @return my_content* 
  */
-my_content* content_make(const char* text) {
-    if (text == NULL) {
-        printf("text is NULL!\n");
-        return NULL;
-    }
-
-    my_content* content = malloc(sizeof(my_content));
-    content->text = malloc(strlen(text)+1);
-    strcpy(content->text, text);
-    return content;
-}
+typedef struct my_dll_list {
+    my_dll* head;
+    my_dll* tail;
+    size_t count;
+    list_pool* pool;
+    list_index* index;
+    list_arena* arena;
+    list_skip* skip;
+    list_file* file;
+    bool arena_mode;
+    size_t loose;
+} my_dll_list;
 
 /**
- * @brief Free the content
+ * @brief Making a node with a given content, for the given list.
+ *        The node comes from the pool of the list when it has one.
+ *        Lists in arena mode take no nodes for contents made apart:
+ *        use dll_make_text_node for them.
  * 
+ * @param list 
  * @param content 
- * @return my_content* 
+ * @return my_dll* 
  */
-my_content* content_free(my_content* content) {
+my_dll* dll_make_node(my_dll_list* list, my_content* content) {
     if (content == NULL) {
-        printf("content is NULL!\n");
-        return content;
+        LOG_ERROR("content is NULL!\n");
+        return NULL;
     }
 
-    printf("freeing content node ...\n");
-    if (content->text != NULL) {
-        free(content->text);
+    if (list != NULL && list->arena_mode) {
+        LOG_ERROR("arena lists take text nodes only (dll_make_text_node)!\n");
+        return NULL;
     }
-    free(content);
-    return NULL;
+
+    my_dll* node;
+    if (list != NULL && list->pool != NULL) {
+        node = list_pool_alloc(list->pool);
+        LIST_STATS_ADD(node_bytes, list->pool->node_size);
+        node->content = content;
+    } else {
+        node = malloc(sizeof(my_dll));
+        LIST_STATS_ADD(node_bytes, sizeof(my_dll));
+        node->content = content;
+    }
+    LIST_STATS_ADD(node_allocs, 1);
+    node->prev_ptr = NULL;
+    node->next_ptr = NULL;
+    return node;
 }
 
 /**
- * @brief Compare if two contents are the same.
+ * @brief node size for a pool whose nodes can hold texts of up to
+ *        `capacity` characters inline (small-string mode).
  * 
- * @param c1 
- * @param c2 
- * @return true 
- * @return false 
  */
-bool content_equals(my_content* c1, my_content* c2) {
-    if (c1 == NULL || c2 == NULL) {
-        return false;
-    }
+#define DLL_SSO_NODE_SIZE(capacity) (sizeof(my_dll) + CONTENT_SIZE(capacity))
 
-    return !strcmp((*c1).text, c2->text); // 1 way to dereference a ptr.
+/**
+ * @brief true when the content of the node lives inside the node's
+ *        own allocation and must not be freed on its own.
+ * 
+ */
+static inline bool dll_node_embeds_content(my_dll* node) {
+    return node->content == (my_content*)(node + 1);
 }
 
 /**
- * @brief Making a node with a given content.
+ * @brief Making a node and its content for a given text. Without a
+ *        pool, node and content share one malloc. With a pool, the
+ *        content is embedded when the text fits in the pool's node
+ *        size (see DLL_SSO_NODE_SIZE), otherwise it is made apart.
+ *        In arena mode, node and content come from the list's arena.
  * 
- * @param content 
+ * @param list 
+ * @param text 
  * @return my_dll* 
  */
-my_dll* dll_make_node(my_content* content) {
-    if (content == NULL) {
-        printf("content is NULL!\n");
+my_dll* dll_make_text_node(my_dll_list* list, const char* text) {
+    if (text == NULL) {
+        LOG_ERROR("text is NULL!\n");
         return NULL;
     }
 
-    my_dll* node = malloc(sizeof(my_dll));
+    size_t length = strlen(text);
+    my_dll* node;
+    LIST_STATS_ADD(node_allocs, 1);
+    if (list != NULL && list->arena_mode) {
+        node = list_arena_alloc(list->arena, sizeof(my_dll) + CONTENT_SIZE(length));
+        if (node == NULL) {
+            return NULL;
+        }
+        LIST_STATS_ADD(node_bytes, sizeof(my_dll) + CONTENT_SIZE(length));
+        node->content = content_init(node + 1, text, length);
+    } else if (list != NULL && list->pool != NULL) {
+        node = list_pool_alloc(list->pool);
+        LIST_STATS_ADD(node_bytes, list->pool->node_size);
+        if (list->pool->node_size < sizeof(my_dll) + CONTENT_SIZE(length)) {
+            node->content = content_make(text);
+        } else {
+            node->content = content_init(node + 1, text, length);
+        }
+    } else {
+        node = malloc(sizeof(my_dll) + CONTENT_SIZE(length));
+        LIST_STATS_ADD(node_bytes, sizeof(my_dll) + CONTENT_SIZE(length));
+        node->content = content_init(node + 1, text, length);
+    }
     node->prev_ptr = NULL;
     node->next_ptr = NULL;
-    node->content = content;
     return node;
 }
 
 /**
- * @brief Making the list
+ * @brief Making the list with its nodes allocated from a given pool.
+ * 
+ * @cond content cannot be NULL. pool may be NULL to use malloc.
  * 
+ * @param pool 
  * @param content 
- * @return my_dll* 
+ * @return my_dll_list* 
  */
-my_dll* dll_make_list(my_content* content) {
+my_dll_list* dll_make_list_with_pool(list_pool* pool, my_content* content) {
     if (content == NULL) {
-        printf("content is NULL!\n");
+        LOG_ERROR("content is NULL!\n");
+        return NULL;
+    }
+    if (pool != NULL && pool->node_size < sizeof(my_dll)) {
+        LOG_ERROR("pool nodes are too small!\n");
         return NULL;
     }
 
-    return dll_make_node(content);
+    my_dll_list* list = malloc(sizeof(my_dll_list));
+    list->pool = pool;
+    list->index = NULL;
+    list->arena = NULL;
+    list->skip = NULL;
+    list->file = NULL;
+    list->arena_mode = false;
+    list->loose = 0;
+    list->head = dll_make_node(list, content);
+    list->tail = list->head;
+    list->count = 1;
+    return list;
+}
+
+/**
+ * @brief Making the list
+ * 
+ * @param content 
+ * @return my_dll_list* 
+ */
+my_dll_list* dll_make_list(my_content* content) {
+    return dll_make_list_with_pool(NULL, content);
+}
+
+/**
+ * @brief Making the list from an array of texts, in one pass and
+ *        without walking the list. Every node carries its text inline
+ *        and all nodes come from one contiguous arena owned by the
+ *        list, so dll_clear_list / dll_remove_list release them at
+ *        once. Nodes added later come from malloc (or the pool).
+ * 
+ * @cond texts and every text in it cannot be NULL. count may be 0.
+ * 
+ * @param texts 
+ * @param count 
+ * @return my_dll_list* 
+ */
+my_dll_list* dll_from_array(const char* const* texts, size_t count) {
+    if (texts == NULL && count > 0) {
+        LOG_ERROR("texts is NULL!\n");
+        return NULL;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (texts[i] == NULL) {
+            LOG_ERROR("text %zu is NULL!\n", i);
+            return NULL;
+        }
+        total += list_pool_align(sizeof(my_dll) + CONTENT_SIZE(strlen(texts[i])));
+    }
+
+    my_dll_list* list = malloc(sizeof(my_dll_list));
+    list->pool = NULL;
+    list->index = NULL;
+    list->arena = count > 0 ? list_arena_make(total) : NULL;
+    list->skip = NULL;
+    list->file = NULL;
+    list->arena_mode = false;
+    list->loose = 0;
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = count;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t length = strlen(texts[i]);
+        my_dll* node = list_arena_alloc(list->arena, sizeof(my_dll) + CONTENT_SIZE(length));
+        LIST_STATS_ADD(node_allocs, 1);
+        LIST_STATS_ADD(node_bytes, sizeof(my_dll) + CONTENT_SIZE(length));
+        node->content = content_init(node + 1, texts[i], length);
+        node->prev_ptr = list->tail;
+        node->next_ptr = NULL;
+        if (list->tail == NULL) {
+            list->head = node;
+        } else {
+            list->tail->next_ptr = node;
+        }
+        list->tail = node;
+    }
+    return list;
+}
+
+/**
+ * @brief Making an empty list in arena mode: the nodes made for it by
+ *        dll_make_text_node, and their contents, are carved from the
+ *        list's arena; dll_make_node refuses to make nodes for it.
+ *        Removing a node does not give its memory back;
+ *        dll_clear_list does, for all nodes at once, and keeps the
+ *        largest block for the nodes made next. dll_remove_list takes
+ *        a few free calls, however long the list is.
+ * 
+ * @param block_size size of the first arena block, 0 for the default.
+ * @return my_dll_list* 
+ */
+my_dll_list* dll_make_arena_list(size_t block_size) {
+    my_dll_list* list = dll_from_array(NULL, 0);
+    list->arena = list_arena_make(block_size);
+    list->arena_mode = true;
+    return list;
 }
 
 /**
- * @brief Freeing a node including its content.
+ * @brief Freeing a node including its content. The node goes back
+ *        to the pool of the list it was made for; nodes of the list's
+ *        arena stay until the arena is freed.
  * 
+ * @param list 
  * @param node 
  * @return my_dll* 
  */
-my_dll* dll_free_node(my_dll* node) {
+my_dll* dll_free_node(my_dll_list* list, my_dll* node) {
     if (node == NULL) {
-        printf("node is NULL!\n");
+        LOG_ERROR("node is NULL!\n");
         return node;
     }
 
-    printf("freeing sll node ...\n");
-    content_free(node->content);
-    free(node);
+    LOG_DEBUG("freeing dll node ...\n");
+    if (!dll_node_embeds_content(node) && !(list != NULL && list_file_owns(list->file, node->content))) {
+        content_free(node->content);
+    }
+    LIST_STATS_ADD(node_frees, 1);
+    if (list != NULL && list_arena_owns(list->arena, node)) {
+        return NULL;
+    }
+    if (list != NULL && list->pool != NULL) {
+        list_pool_release(list->pool, node);
+    } else {
+        free(node);
+    }
     return NULL;
 }
 
+/**
+ * @brief true when the node is not from the arena of the list, so it
+ *        has to be freed on its own when the list is cleared.
+ * 
+ */
+static inline bool dll_node_is_loose(my_dll_list* list, my_dll* node) {
+    return list->arena != NULL && !list_arena_owns(list->arena, node);
+}
+
+/**
+ * @brief the number of nodes that have to be freed one by one.
+ * 
+ */
+static inline size_t dll_loose_count(my_dll_list* list) {
+    return list->arena != NULL ? list->loose : list->count;
+}
+
+/**
+ * @brief true when the node can go between prev and next (either may
+ *        be NULL) without breaking the order of a sorted list.
+ * 
+ */
+static inline bool dll_fits_between(my_dll* prev, my_dll* node, my_dll* next) {
+    return (prev == NULL || content_compare(prev->content, node->content) <= 0) &&
+        (next == NULL || content_compare(node->content, next->content) <= 0);
+}
+
+/**
+ * @brief Counting a node just linked into the list and adding it to
+ *        the index and the skip list, if any.
+ * 
+ */
+static void dll_link_done(my_dll_list* list, my_dll* node) {
+    list->count++;
+    if (dll_node_is_loose(list, node)) {
+        list->loose++;
+    }
+    if (list->index != NULL) {
+        list_index_add(list->index, node, node->content);
+    }
+    if (list->skip != NULL) {
+        list_skip_add(list->skip, node, node->content);
+    }
+}
+
+/**
+ * @brief Linking a node after the last one, without checks or
+ *        tracing, for the operations built on it.
+ * 
+ */
+static void dll_link_back(my_dll_list* list, my_dll* node) {
+    node->next_ptr = NULL;
+    node->prev_ptr = list->tail;
+    if (list->tail == NULL) {
+        list->head = node;
+    } else {
+        list->tail->next_ptr = node;
+    }
+    list->tail = node;
+    dll_link_done(list, node);
+}
+
+/**
+ * @brief Linking a node in front of `at`, a node of the list,
+ *        without checks or tracing.
+ * 
+ */
+static void dll_link_before(my_dll_list* list, my_dll* at, my_dll* node) {
+    node->next_ptr = at;
+    node->prev_ptr = at->prev_ptr;
+    if (at->prev_ptr == NULL) {
+        list->head = node;
+    } else {
+        at->prev_ptr->next_ptr = node;
+    }
+    at->prev_ptr = node;
+    dll_link_done(list, node);
+}
+
 /**
  * @brief Adding a given node at the end of the list. It becomes
- *        the last node in the list.
+ *        the last node in the list. With a skip list attached, a node
+ *        smaller than the last one gives LIST_ERR_ORDER.
  * 
- * @param head 
+ * @param list 
  * @param node 
- * @return my_dll* 
+ * @return list_status 
  */
-my_dll* dll_append_node(my_dll* head, my_dll* node) {
-    if (node == NULL) {
-        printf("node is NULL!\n");
-        return head;
+list_status dll_append_node(my_dll_list* list, my_dll* node) {
+    if (list == NULL || node == NULL) {
+        LOG_ERROR("list and/or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->skip != NULL && !dll_fits_between(list->tail, node, NULL)) {
+        LOG_ERROR("node is out of order!\n");
+        return LIST_ERR_ORDER;
     }
 
-    my_dll* last_node = head;
-    while (last_node-> next_ptr != NULL) {
-        last_node = last_node->next_ptr;
+    LIST_TRACE_OP(LIST_TRACE_APPEND, list->count);
+    dll_link_back(list, node);
+    return LIST_OK;
+}
+
+/**
+ * @brief Adding a given node in front of the list. It becomes
+ *        the first node in the list. With a skip list attached, a
+ *        node greater than the first one gives LIST_ERR_ORDER.
+ * 
+ * @param list 
+ * @param node 
+ * @return list_status 
+ */
+list_status dll_prepend_node(my_dll_list* list, my_dll* node) {
+    if (list == NULL || node == NULL) {
+        LOG_ERROR("list and/or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->skip != NULL && !dll_fits_between(NULL, node, list->head)) {
+        LOG_ERROR("node is out of order!\n");
+        return LIST_ERR_ORDER;
     }
-    last_node->next_ptr = node;
-    node->prev_ptr = last_node;
-    return head;
+
+    LIST_TRACE_OP(LIST_TRACE_INSERT, list->count);
+    if (list->head == NULL) {
+        dll_link_back(list, node);
+    } else {
+        dll_link_before(list, list->head, node);
+    }
+    return LIST_OK;
 }
 
 /**
- * @brief Inserting a node in a list.
+ * @brief Inserting a node in a list, in front of `at`. With a skip
+ *        list attached, a node that does not fit between `at` and
+ *        the node before it gives LIST_ERR_ORDER.
  * 
- * @param head 
+ * @param list 
  * @param at 
  * @param new_node 
- * @return my_dll* 
+ * @return list_status 
  */
-my_dll* dll_insert_node(my_dll* head, my_dll* at, my_dll* new_node) {
-    if (head == NULL || at == NULL || new_node == NULL) {
-        printf("list is empty or at is NULL or new_node is NULL!\n");
-        return head;
+list_status dll_insert_node(my_dll_list* list, my_dll* at, my_dll* new_node) {
+    if (list == NULL || at == NULL || new_node == NULL) {
+        LOG_ERROR("list or at or new_node is NULL!\n");
+        return LIST_ERR_NULL;
     }
-
-    // inserting at head
-    if (at == head) {
-        new_node->next_ptr = head;
-        head->prev_ptr = new_node;
-        new_node->prev_ptr = NULL;
-        return new_node;
+    if (list->head == NULL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+    if (list->skip != NULL && !dll_fits_between(at->prev_ptr, new_node, at)) {
+        LOG_ERROR("new_node is out of order!\n");
+        return LIST_ERR_ORDER;
     }
 
-    // insert in the middle
-    new_node->next_ptr = at;
-    new_node->prev_ptr = at->prev_ptr;
-    at->prev_ptr->next_ptr = new_node;
-    at->prev_ptr = new_node;
-    return head;
+    LIST_TRACE_OP(LIST_TRACE_INSERT, list->count);
+    dll_link_before(list, at, new_node);
+    return LIST_OK;
 }
 
 /**
  * @brief Removing a node from the list (DONOT FREE THE NODE)
  * 
- * @param head 
+ * @param list 
  * @param at 
+ * @return list_status 
+ */
+
+list_status dll_remove_node(my_dll_list* list, my_dll* at) {
+    if (list == NULL || at == NULL) {
+        LOG_ERROR("list and/or at is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->head == NULL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_REMOVE, list->count);
+    if (at == list->head) {
+        list->head = at->next_ptr;
+    } else {
+        at->prev_ptr->next_ptr = at->next_ptr;
+    }
+
+    if (at == list->tail) {
+        list->tail = at->prev_ptr;
+    } else {
+        at->next_ptr->prev_ptr = at->prev_ptr;
+    }
+
+    at->prev_ptr = NULL;
+    at->next_ptr = NULL;
+    list->count--;
+    if (dll_node_is_loose(list, at)) {
+        list->loose--;
+    }
+    if (list->index != NULL) {
+        list_index_remove(list->index, at, at->content);
+    }
+    if (list->skip != NULL) {
+        list_skip_remove(list->skip, at, at->content);
+    }
+    return LIST_OK;
+}
+
+/**
+ * @brief getting the size of the list. The count is maintained by
+ *        every operation that changes the list, so this is O(1).
+ * 
+ * @param list 
+ * @return size_t 
+ */
+size_t dll_size(my_dll_list* list) {
+    if (list == NULL) {
+        return 0;
+    }
+
+    return list->count;
+}
+
+/**
+ * @brief Returns the last node of the list
+ * 
+ * @param list 
  * @return my_dll* 
  */
+my_dll* dll_get_last_node(my_dll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return NULL;
+    }
+
+    return list->tail;
+}
 
-my_dll* dll_remove_node(my_dll* head, my_dll* at) {
-    if (head == NULL || at == NULL) {
-        printf("head and/or at is NULL!\n");
-        return head;
+/**
+ * @brief writing the contents of the list, in the format of
+ *        dll_print_list, through a buffered writer (list_writer.h).
+ * 
+ * @param list 
+ * @param writer 
+ * @return list_status LIST_ERR_IO when writing failed.
+ */
+list_status dll_write_list(my_dll_list* list, list_writer* writer) {
+    if (writer == NULL) {
+        LOG_ERROR("writer is NULL!\n");
+        return LIST_ERR_NULL;
     }
+    if (list == NULL || list->head == NULL) {
+        list_writer_string(writer, ">>> list is empty!\n");
+        return writer->failed ? LIST_ERR_IO : LIST_OK;
+    }
+
+    size_t node_no = 1;
+    for (my_dll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        list_writer_node(writer, node_no++, cur->content);
+    }
+    list_writer_string(writer, ">>> list size: ");
+    list_writer_number(writer, list->count);
+    list_writer_text(writer, "\n", 1);
+    return writer->failed ? LIST_ERR_IO : LIST_OK;
+}
+
+/**
+ * @brief writing the contents of the list in a reverse order, in the
+ *        format of dll_print_list_reverse. The colors are left out
+ *        when the writer has them off.
+ * 
+ * @param list 
+ * @param writer 
+ * @return list_status LIST_ERR_IO when writing failed.
+ */
+list_status dll_write_list_reverse(my_dll_list* list, list_writer* writer) {
+    if (writer == NULL) {
+        LOG_ERROR("writer is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list == NULL || list->head == NULL) {
+        list_writer_string(writer, "list is empty!\n");
+        return writer->failed ? LIST_ERR_IO : LIST_OK;
+    }
+
+    list_writer_color(writer, YEL);
+    list_writer_string(writer, "printing list in reverse order...");
+    list_writer_color(writer, reset);
+    list_writer_text(writer, "\n", 1);
+    size_t count = list->count;
+    for (my_dll* cur = list->tail; cur != NULL; cur = cur->prev_ptr) {
+        list_writer_node(writer, count--, cur->content);
+    }
+    list_writer_string(writer, ">>> list size: ");
+    list_writer_number(writer, list->count);
+    list_writer_text(writer, "\n", 1);
+    return writer->failed ? LIST_ERR_IO : LIST_OK;
+}
+
+/**
+ * @brief printing the contents of the list
+ * 
+ * @param list 
+ */
+void dll_print_list(my_dll_list* list) {
+    list_writer writer;
+    list_writer_init_file(&writer, stdout, LIST_COLOR_AUTO);
+    dll_write_list(list, &writer);
+    list_writer_release(&writer);
+}
 
-    if (at == head) {
-        head = head->next_ptr;
-        if (head != NULL) {
-            head->prev_ptr = NULL;
+/**
+ * @brief print the contents of the list in a reverse order,
+ *        starting from the tail.
+ * 
+ * @param list 
+ */
+void dll_print_list_reverse(my_dll_list* list) {
+    list_writer writer;
+    list_writer_init_file(&writer, stdout, LIST_COLOR_AUTO);
+    dll_write_list_reverse(list, &writer);
+    list_writer_release(&writer);
+}
+
+/**
+ * @brief Freeing all the nodes, without checks or tracing, for
+ *        dll_clear_list, dll_remove_list and dll_stream_batches.
+ * 
+ */
+static void dll_free_nodes(my_dll_list* list) {
+    if (dll_loose_count(list) > 0) {
+        my_dll* head = list->head;
+        while (head != NULL) {
+            my_dll* cur = head;
+            head = head-> next_ptr;
+            dll_free_node(list, cur);
         }
     } else {
-        at->prev_ptr->next_ptr = at->next_ptr;
-        if (at->next_ptr != NULL) {
-            at->next_ptr->prev_ptr = at->prev_ptr;
+        LIST_STATS_ADD(node_frees, list->count);
+    }
+
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+    list->loose = 0;
+    if (list->arena_mode) {
+        list_arena_reset(list->arena);
+    } else {
+        list->arena = list_arena_free(list->arena);
+    }
+    list->file = list_file_unmap(list->file);
+    if (list->index != NULL) {
+        list_index_clear(list->index);
+    }
+    if (list->skip != NULL) {
+        list_skip_clear(list->skip);
+    }
+}
+
+/**
+ * @brief Removing and freeing all the nodes in the list. The list
+ *        handle stays valid and is empty afterwards. When all nodes
+ *        come from the list's arena, the list is not walked: the
+ *        arena goes away as a whole (in arena mode it is reset and
+ *        kept for the nodes made next).
+ * 
+ * @param list 
+ * @return list_status 
+ */
+list_status dll_clear_list(my_dll_list* list) {
+    if (list == NULL) {
+        return LIST_ERR_NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_REMOVE_ALL, list->count);
+    dll_free_nodes(list);
+    return LIST_OK;
+}
+
+/**
+ * @brief Removing all the node in the list, including the head node,
+ *        and the list handle. return NULL when complete.
+ * 
+ * @param list 
+ * @return my_dll_list* 
+ */
+my_dll_list* dll_remove_list(my_dll_list* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_REMOVE_ALL, list->count);
+    dll_free_nodes(list);
+    list_arena_free(list->arena);
+    list_index_free(list->index);
+    list_skip_free(list->skip);
+    free(list);
+    return NULL;
+}
+
+/**
+ * @brief The first node whose content is not smaller than the given
+ *        one, NULL when there is none. With a skip list attached this
+ *        is O(log n), otherwise the list is walked from the head.
+ * 
+ * @cond the list must be sorted.
+ * 
+ * @param list 
+ * @param content 
+ * @return my_dll* 
+ */
+my_dll* dll_lower_bound(my_dll_list* list, const my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list and/or content is NULL!\n");
+        return NULL;
+    }
+
+    my_dll* cur = list->head;
+    if (list->skip != NULL) {
+        list_skip_tower* tower = list_skip_find_before(list->skip, content, false, NULL);
+        if (tower != NULL) {
+            cur = ((my_dll*)tower->node)->next_ptr;
         }
     }
-    return head;
+    while (cur != NULL && content_compare(cur->content, content) < 0) {
+        cur = cur->next_ptr;
+    }
+    return cur;
 }
 
 /**
- * @brief getting the size of the list.
+ * @brief The first node whose content is greater than the given one,
+ *        NULL when there is none. Together with dll_lower_bound it
+ *        gives a range of keys:
  * 
- * @param head 
- * @return int 
+ *        for (cur = dll_lower_bound(list, from); cur != dll_upper_bound(list, to); ...)
+ * 
+ * @cond the list must be sorted.
+ * 
+ * @param list 
+ * @param content 
+ * @return my_dll* 
  */
-int dll_size(my_dll* head) {
-    my_dll* cur = head;
-    int count = 0;
-    while (cur != NULL) {
-        count++;
+my_dll* dll_upper_bound(my_dll_list* list, const my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list and/or content is NULL!\n");
+        return NULL;
+    }
+
+    my_dll* cur = list->head;
+    if (list->skip != NULL) {
+        list_skip_tower* tower = list_skip_find_before(list->skip, content, true, NULL);
+        if (tower != NULL) {
+            cur = ((my_dll*)tower->node)->next_ptr;
+        }
+    }
+    while (cur != NULL && content_compare(cur->content, content) <= 0) {
         cur = cur->next_ptr;
     }
-    return count;
+    return cur;
 }
 
 /**
- * @brief Returns the last node of the list
+ * @brief Linking a node after the nodes not greater than it, without
+ *        checks or tracing. It fits there, so the skip list never
+ *        refuses it.
  * 
- * @param head 
+ */
+static void dll_link_sorted(my_dll_list* list, my_dll* node) {
+    my_dll* at = dll_upper_bound(list, node->content);
+    if (at == NULL) {
+        dll_link_back(list, node);
+    } else {
+        dll_link_before(list, at, node);
+    }
+}
+
+/**
+ * @brief Inserting a node at its place in a sorted list, after the
+ *        nodes with the same content.
+ * 
+ * @cond the list must be sorted.
+ * 
+ * @param list 
+ * @param node 
+ * @return list_status 
+ */
+list_status dll_insert_sorted(my_dll_list* list, my_dll* node) {
+    if (list == NULL || node == NULL) {
+        LOG_ERROR("list and/or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_INSERT, list->count);
+    dll_link_sorted(list, node);
+    return LIST_OK;
+}
+
+/**
+ * @brief Searching for a node with a given content. With an index
+ *        attached this is a hash lookup; among several nodes with the
+ *        same text it returns one of them, not necessarily the first.
+ *        With a skip list attached (and no index) it returns the
+ *        first one, in O(log n).
+ * 
+ * @param list 
+ * @param content 
  * @return my_dll* 
  */
-my_dll* dll_get_last_node(my_dll* head) {
-    if (head == NULL) {
-        printf("head is NULL!\n");
+my_dll* dll_search_node(my_dll_list* list, my_content* content) {
+    if (list == NULL || list->head == NULL) {
+        LOG_DEBUG("list is empty!\n");
         return NULL;
     }
 
-    my_dll* last = head;
-    while (last->next_ptr != NULL) {
-        last = last->next_ptr;
+    LIST_TRACE_OP(LIST_TRACE_SEARCH, list->count);
+    LIST_STATS_ADD(searches, 1);
+    if (list->index != NULL) {
+        list_index_entry* entry = list_index_find(list->index, content);
+        return entry != NULL ? entry->node : NULL;
+    }
+    if (list->skip != NULL) {
+        my_dll* node = dll_lower_bound(list, content);
+        return node != NULL && content_equals(node->content, content) ? node : NULL;
+    }
+
+    size_t visits = 0;
+    my_dll* search_node = list->head;
+    while(search_node != NULL) {
+        visits++;
+        if (content_equals(search_node->content, content)) {
+            break;
+        }
+        search_node = search_node->next_ptr;
     }
-    return last;
+    LIST_STATS_ADD(search_visits, visits);
+    return search_node;
 }
 
 /**
- * @brief printing the contents of the list
+ * @brief Building a hash index over the contents of the list. From
+ *        then on dll_search_node is O(1) on average and every
+ *        operation that changes the list keeps the index up to date.
+ * 
+ * @param list 
+ * @return list_status 
+ */
+list_status dll_attach_index(my_dll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->index != NULL) {
+        return LIST_OK;
+    }
+
+    list->index = list_index_make(list->count);
+    for (my_dll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        list_index_add(list->index, cur, cur->content);
+    }
+    return LIST_OK;
+}
+
+/**
+ * @brief Dropping the hash index, dll_search_node walks the list again.
  * 
- * @param head 
+ * @param list 
+ * @return list_status 
  */
-void dll_print_list(my_dll* head) {
-    if (head == NULL) {
-        printf(">>> list is empty!\n");
-        return;
+list_status dll_detach_index(my_dll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
     }
+    list->index = list_index_free(list->index);
+    return LIST_OK;
+}
 
-    my_dll* cur = head;
-    int node_no = 1;
+/**
+ * @brief Merging two sorted chains of nodes into one, through their
+ *        next_ptr only. On equal contents the node of `a` comes first,
+ *        which keeps sorting stable.
+ * 
+ */
+static my_dll* dll_merge_runs(my_dll* a, my_dll* b, content_compare_fn compare) {
+    my_dll merged;
+    my_dll* tail = &merged;
+    while (a != NULL && b != NULL) {
+        if (compare(b->content, a->content) < 0) {
+            tail->next_ptr = b;
+            b = b->next_ptr;
+        } else {
+            tail->next_ptr = a;
+            a = a->next_ptr;
+        }
+        tail = tail->next_ptr;
+    }
+    tail->next_ptr = a != NULL ? a : b;
+    return merged.next_ptr;
+}
+
+/**
+ * @brief Setting the head, the prev_ptr links and the tail again after
+ *        the nodes were relinked through next_ptr.
+ * 
+ */
+static void dll_relink_prev(my_dll_list* list, my_dll* head) {
+    my_dll* prev = NULL;
+    for (my_dll* cur = head; cur != NULL; cur = cur->next_ptr) {
+        cur->prev_ptr = prev;
+        prev = cur;
+    }
+    list->head = head;
+    list->tail = prev;
+}
+
+#define DLL_SORT_BINS 64
+
+/**
+ * @brief Sorting the list in place, stable and in O(n log n), by
+ *        relinking its nodes: nothing is allocated or copied. Bottom-up
+ *        merge sort on the next_ptr chain (bin i holds a sorted run of
+ *        2^i nodes), then one pass puts the prev_ptr links back.
+ * 
+ *        With a skip list attached the list is sorted already; another
+ *        order than content_compare gives LIST_ERR_ORDER.
+ * 
+ * @param list 
+ * @param compare NULL for content_compare (strcmp order).
+ * @return list_status 
+ */
+list_status dll_sort(my_dll_list* list, content_compare_fn compare) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (compare == NULL) {
+        compare = content_compare;
+    }
+    if (list->skip != NULL) {
+        return compare == content_compare ? LIST_OK : LIST_ERR_ORDER;
+    }
+
+    my_dll* bins[DLL_SORT_BINS] = { NULL };
+    my_dll* cur = list->head;
     while (cur != NULL) {
-        printf("%d. %s\n", node_no, cur->content->text);
+        my_dll* run = cur;
         cur = cur->next_ptr;
-        node_no++;
+        run->next_ptr = NULL;
+        size_t i = 0;
+        // the runs in the bins are older than the new one, they go first.
+        for (; i < DLL_SORT_BINS - 1 && bins[i] != NULL; i++) {
+            run = dll_merge_runs(bins[i], run, compare);
+            bins[i] = NULL;
+        }
+        bins[i] = dll_merge_runs(bins[i], run, compare);
     }
-    printf(">>> list size: %d\n", node_no-1);
-    return;
+
+    my_dll* sorted = NULL;
+    for (size_t i = 0; i < DLL_SORT_BINS; i++) {
+        sorted = dll_merge_runs(bins[i], sorted, compare);
+    }
+    dll_relink_prev(list, sorted);
+    return LIST_OK;
 }
 
 /**
- * @brief print the contents of the list in a reverse order.
+ * @brief Moving all nodes of `other` into the list, in order, in
+ *        O(n + m). On equal contents the nodes of the list come first.
+ *        The nodes of other's arena go along with them; other is left
+ *        empty. A skip list attached to the list gets its towers built
+ *        again, which makes the merge O((n + m) log(n + m)).
  * 
- * @param head 
+ * @cond both lists must be sorted with `compare` and take their nodes
+ *       from the same pool (or none).
+ * 
+ * @param list 
+ * @param other 
+ * @param compare NULL for content_compare (strcmp order).
+ * @return list_status 
  */
-void dll_print_list_reverse(my_dll* head) {
-    if (head == NULL) {
-        printf("list is empty!\n");
-        return;
+list_status dll_merge(my_dll_list* list, my_dll_list* other, content_compare_fn compare) {
+    if (list == NULL || other == NULL) {
+        LOG_ERROR("list and/or other is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list == other) {
+        return LIST_OK;
+    }
+    if (compare == NULL) {
+        compare = content_compare;
+    }
+    if ((list->skip != NULL || other->skip != NULL) && compare != content_compare) {
+        return LIST_ERR_ORDER;
     }
 
-    printf("%sprinting list in reverse order...%s\n", YEL, reset);
-    my_dll* last = head;
-    int count = 1;
-    while (last->next_ptr != NULL) {
-        last = last->next_ptr;
-        count++;
+    if (list->index != NULL) {
+        for (my_dll* cur = other->head; cur != NULL; cur = cur->next_ptr) {
+            list_index_add(list->index, cur, cur->content);
+        }
+    }
+    if (other->index != NULL) {
+        list_index_clear(other->index);
+    }
+    if (other->skip != NULL) {
+        list_skip_clear(other->skip);
     }
 
-    int size = count;
-    my_dll* cur = last;
-    while (cur != NULL) {
-        printf("%d. %s\n", count--, cur->content->text);
-        cur = cur->prev_ptr;
+    size_t loose = dll_loose_count(list) + dll_loose_count(other);
+    dll_relink_prev(list, dll_merge_runs(list->head, other->head, compare));
+    list->count += other->count;
+    list->arena = list_arena_merge(list->arena, other->arena);
+    list->loose = loose;
+    list->file = list_file_merge(list->file, other->file);
+    if (list->skip != NULL) {
+        list_skip_clear(list->skip);
+        for (my_dll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+            list_skip_add(list->skip, cur, cur->content);
+        }
     }
-    printf(">>> list size: %d\n", size);
-    return;
+
+    other->head = NULL;
+    other->tail = NULL;
+    other->count = 0;
+    other->loose = 0;
+    other->arena = other->arena_mode ? list_arena_make(0) : NULL;
+    other->file = NULL;
+    return LIST_OK;
 }
+
 /**
- * @brief Removing all the node in the list, including the head node.
- *        return NULL when complete.
+ * @brief Writing the contents of the list to a list file
+ *        (list_file.h), from head to tail.
  * 
- * @param head 
- * @return my_dll* 
+ * @param list 
+ * @param path 
+ * @return list_status LIST_ERR_IO when the file cannot be written.
  */
-my_dll* dll_remove_list(my_dll* head) {
+list_status dll_save(my_dll_list* list, const char* path) {
+    if (list == NULL || path == NULL) {
+        LOG_ERROR("list and/or path is NULL!\n");
+        return LIST_ERR_NULL;
+    }
 
-    while (head != NULL) {
-        my_dll* cur = head;
-        head = head-> next_ptr;
-        dll_free_node(cur);
+    list_file_writer* writer = list_file_writer_open(path);
+    if (writer == NULL) {
+        return LIST_ERR_IO;
     }
+    list_status status = LIST_OK;
+    for (my_dll* cur = list->head; cur != NULL && status == LIST_OK; cur = cur->next_ptr) {
+        status = list_file_write(writer, cur->content);
+    }
+    list_status closed = list_file_writer_close(writer);
+    return status != LIST_OK ? status : closed;
+}
 
-    return NULL;
+/**
+ * @brief Making a list from a list file without copying any text: the
+ *        file is mapped and the content of every node points into the
+ *        mapping. The nodes come from one arena, like with
+ *        dll_from_array. Every record is checked (bounds, '\0',
+ *        hash) as its node is made, so the load reads the whole file:
+ *        O(file size). The contents are read-only; the list itself
+ *        can be changed as usual and the mapping goes away with
+ *        dll_clear_list / dll_remove_list.
+ * 
+ * @param path 
+ * @return my_dll_list* NULL when the file cannot be mapped or is
+ *         damaged.
+ */
+my_dll_list* dll_load(const char* path) {
+    if (path == NULL) {
+        LOG_ERROR("path is NULL!\n");
+        return NULL;
+    }
+    list_file* file = list_file_map(path);
+    if (file == NULL) {
+        return NULL;
+    }
+
+    my_dll_list* list = malloc(sizeof(my_dll_list));
+    list->pool = NULL;
+    list->index = NULL;
+    list->arena = file->count > 0 ? list_arena_make(file->count * list_pool_align(sizeof(my_dll))) : NULL;
+    list->skip = NULL;
+    list->file = file;
+    list->arena_mode = false;
+    list->loose = 0;
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+
+    for (uint64_t i = 0; i < file->count; i++) {
+        const my_content* content = list_file_content(file, i);
+        if (content == NULL) {
+            LOG_ERROR("record %llu of %s is damaged!\n", (unsigned long long)i, path);
+            return dll_remove_list(list);
+        }
+        my_dll* node = list_arena_alloc(list->arena, sizeof(my_dll));
+        LIST_STATS_ADD(node_allocs, 1);
+        LIST_STATS_ADD(node_bytes, sizeof(my_dll));
+        node->content = (my_content*)content;
+        node->prev_ptr = list->tail;
+        node->next_ptr = NULL;
+        if (list->tail == NULL) {
+            list->head = node;
+        } else {
+            list->tail->next_ptr = node;
+        }
+        list->tail = node;
+        list->count++;
+    }
+    return list;
+}
+
+/**
+ * @brief Appending a line as a text node carved from the list's arena.
+ * 
+ */
+static list_status dll_append_line(my_dll_list* list, const char* text, size_t length) {
+    my_dll* node = list_arena_alloc(list->arena, sizeof(my_dll) + CONTENT_SIZE(length));
+    if (node == NULL) {
+        return LIST_ERR_NO_MEMORY;
+    }
+    LIST_STATS_ADD(node_allocs, 1);
+    LIST_STATS_ADD(node_bytes, sizeof(my_dll) + CONTENT_SIZE(length));
+    node->content = content_init(node + 1, text, length);
+    node->prev_ptr = list->tail;
+    node->next_ptr = NULL;
+    if (list->tail == NULL) {
+        list->head = node;
+    } else {
+        list->tail->next_ptr = node;
+    }
+    list->tail = node;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief Making a list with one node per line read from a file
+ *        descriptor (a file, a pipe, stdin). The input is read in
+ *        large chunks (list_stream.h); node and text of every line
+ *        come from the list's arena, whose blocks double as it
+ *        grows.
+ * 
+ * @param fd read until its end; it is not closed.
+ * @return my_dll_list* NULL when reading failed.
+ */
+my_dll_list* dll_from_stream(int fd) {
+    list_stream stream;
+    list_stream_init(&stream, fd, 0);
+    my_dll_list* list = dll_from_array(NULL, 0);
+    list->arena = list_arena_make(0);
+
+    const char* line;
+    size_t length;
+    list_status status = LIST_OK;
+    while (status == LIST_OK && list_stream_next_line(&stream, &line, &length)) {
+        status = dll_append_line(list, line, length);
+    }
+    bool failed = stream.failed || status != LIST_OK;
+    list_stream_release(&stream);
+    if (failed) {
+        return dll_remove_list(list);
+    }
+    return list;
+}
+
+/**
+ * @brief Handing the lines of a file descriptor to `batch` in lists of
+ *        up to `batch_lines` nodes, so that an input larger than
+ *        memory can be processed: only one batch is in memory at a
+ *        time. The batch list and its contents are freed after the
+ *        callback returns (the arena they come from is reset and used
+ *        again for the next batch); a callback that wants to keep a
+ *        text must copy it.
+ * 
+ * @param fd read until its end; it is not closed.
+ * @param batch_lines lines per batch, at least 1.
+ * @param batch called for every batch; returning anything but LIST_OK
+ *        (LIST_STOP to just stop early) stops the reading and is
+ *        returned.
+ * @param context passed to batch.
+ * @return list_status LIST_ERR_IO when reading failed.
+ */
+list_status dll_stream_batches(int fd, size_t batch_lines, list_status (*batch)(my_dll_list* list, void* context),
+        void* context) {
+    if (batch == NULL || batch_lines == 0) {
+        LOG_ERROR("batch is NULL or batch_lines is 0!\n");
+        return LIST_ERR_NULL;
+    }
+
+    list_stream stream;
+    list_stream_init(&stream, fd, 0);
+    my_dll_list* list = dll_make_arena_list(0);
+    const char* line;
+    size_t length;
+    list_status status = LIST_OK;
+    while (status == LIST_OK) {
+        while (status == LIST_OK && list->count < batch_lines && list_stream_next_line(&stream, &line, &length)) {
+            status = dll_append_line(list, line, length);
+        }
+        if (stream.failed) {
+            status = LIST_ERR_IO;
+        }
+        bool more = list->count == batch_lines;
+        if (status == LIST_OK && list->count > 0) {
+            status = batch(list, context);
+        }
+        dll_free_nodes(list);
+        if (!more) {
+            break;
+        }
+    }
+    list_stream_release(&stream);
+    dll_remove_list(list);
+    return status;
+}
+
+/**
+ * @brief Attaching a skip list, which keeps the list sorted from then
+ *        on: the nodes are put in order (stable, in O(n log n)) and
+ *        dll_search_node, dll_lower_bound, dll_upper_bound and
+ *        dll_insert_sorted take O(log n). Appending, prepending and
+ *        inserting are refused when they would break the order.
+ * 
+ * @param list 
+ * @return list_status 
+ */
+list_status dll_attach_skip(my_dll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->skip != NULL) {
+        return LIST_OK;
+    }
+
+    // the nodes are inserted again one by one; the index does not
+    // depend on their order and is left alone meanwhile.
+    list_index* index = list->index;
+    my_dll* cur = list->head;
+    list->index = NULL;
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+    list->loose = 0;
+    list->skip = list_skip_make();
+    while (cur != NULL) {
+        my_dll* next = cur->next_ptr;
+        dll_link_sorted(list, cur);
+        cur = next;
+    }
+    list->index = index;
+    return LIST_OK;
+}
+
+/**
+ * @brief Dropping the skip list. The list stays in order but is not
+ *        kept sorted any more.
+ * 
+ * @param list 
+ * @return list_status 
+ */
+list_status dll_detach_skip(my_dll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    list->skip = list_skip_free(list->skip);
+    return LIST_OK;
 }
 
 // ****** TEST CODE ****** //
+// Define DLL_NO_MAIN to use the functions above from another program.
+#ifndef DLL_NO_MAIN
 
 const char* test_str_node_0_5 = "*** Node 0.5 ***";
 const char* test_str_node_1_0 = "*** Node 1.0 ***";
@@ -336,137 +1307,164 @@ const char* test_str_node_3_0 = "*** Node 3.0 ***";
 void test_making_dll() {
     printf("%s\ntest_making_dll%s\n", GRN, reset);
     printf("*** making doubly-linked-list correctly\n");
-    my_dll* head = dll_make_list(content_make(test_str_node_1_0));
-    printf("content = %s\n", head->content->text);
-    assert(head != NULL);
-    dll_print_list(head);
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    printf("content = %s\n", list->head->content->text);
+    assert(list != NULL);
+    dll_print_list(list);
 
     printf("*** verify correct content\n");
     my_content* test_content = content_make(test_str_node_1_0);
-    assert(content_equals(head->content, test_content));
-    dll_print_list(head);
+    assert(content_equals(list->head->content, test_content));
+    assert(dll_get_last_node(list) == list->head);
+    content_free(test_content);
+    dll_print_list(list);
 
     printf("*** freeing doubly-linked-list correctly\n");
-    head = dll_free_node(head);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_remove_list(list);
+    assert(list == NULL);
+    dll_print_list(list);
 
     printf("*** making doubly-linked-list incorrectly\n");
-    head = dll_make_list(NULL);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_make_list(NULL);
+    assert(list == NULL);
+    dll_print_list(list);
 
     printf("*** freeing doubly-linked-list incorrectly\n");
-    free(head);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_remove_list(list);
+    assert(list == NULL);
+    dll_print_list(list);
     return;
 }
 
 void test_appending_nodes() {    
     printf("%s\ntest_appending_nodes%s\n", GRN, reset);
     printf("*** making dll list\n");
-    my_dll* head = dll_make_list(content_make(test_str_node_1_0));
-    assert(dll_size(head) == 1);
-    dll_print_list(head);
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    assert(dll_size(list) == 1);
+    dll_print_list(list);
 
     printf("*** appending node correctly!\n");
-    dll_append_node(head, dll_make_node(content_make(test_str_node_2_0)));
-    assert(dll_size(head) == 2);
-    dll_print_list(head);
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_2_0)));
+    assert(dll_size(list) == 2);
+    dll_print_list(list);
 
     printf("*** verifying appended content\n");
     my_content* test_content = content_make(test_str_node_2_0);
-    assert(content_equals(dll_get_last_node(head)->content, test_content));
+    assert(content_equals(dll_get_last_node(list)->content, test_content));
     content_free(test_content);
 
+    printf("*** clearing the list keeps an empty handle\n");
+    dll_clear_list(list);
+    assert(dll_size(list) == 0);
+    assert(list->head == NULL && dll_get_last_node(list) == NULL);
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_1_0)));
+    assert(dll_size(list) == 1);
+    assert(list->head == dll_get_last_node(list));
+    dll_print_list(list);
+
     printf("*** removing the list\n");
-    head = dll_remove_list(head);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_remove_list(list);
+    assert(list == NULL);
+    dll_print_list(list);
 
-    head = dll_make_list(content_make("*** Node 1 ***"));
-    assert(dll_size(head) == 1);
-    dll_print_list(head);
+    list = dll_make_list(content_make("*** Node 1 ***"));
+    assert(dll_size(list) == 1);
+    dll_print_list(list);
 
     printf("*** appending node incorrectly!\n");
-    dll_append_node(head, dll_make_node(NULL));
-    assert(dll_size(head) == 1);
-    dll_print_list(head);
+    dll_append_node(list, dll_make_node(list, NULL));
+    assert(dll_size(list) == 1);
+    dll_print_list(list);
 
     printf("*** removing the list\n");
-    head = dll_remove_list(head);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_remove_list(list);
+    assert(list == NULL);
+    dll_print_list(list);
 
 }
 
-my_dll* dll_search_node(my_dll* head, my_content* content) {
-    if (head == NULL) {
-        printf("list is empty!\n");
-        return NULL;
-    }
+void test_prepending_nodes() {
+    printf("%s\ntest_prepending_nodes%s\n", GRN, reset);
+    printf("*** making dll list\n");
+    my_dll_list* list = dll_make_list(content_make(test_str_node_2_0));
+    my_dll* last = dll_get_last_node(list);
+
+    printf("*** prepending nodes correctly!\n");
+    dll_prepend_node(list, dll_make_node(list, content_make(test_str_node_1_0)));
+    dll_prepend_node(list, dll_make_node(list, content_make(test_str_node_0_5)));
+    assert(dll_size(list) == 3);
+    assert(dll_get_last_node(list) == last);
+    assert(list->head->prev_ptr == NULL);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
+
+    printf("*** verifying prepended content\n");
+    my_content* test_content = content_make(test_str_node_0_5);
+    assert(content_equals(list->head->content, test_content));
+    content_free(test_content);
 
-    my_dll* search_node = head;
-    while(search_node != NULL && !content_equals(search_node->content, content)) {
-        search_node = search_node->next_ptr;
-    }
-    return search_node;
+    printf("*** prepending node incorrectly!\n");
+    dll_prepend_node(list, dll_make_node(list, NULL));
+    assert(dll_size(list) == 3);
+
+    printf("*** removing the list\n");
+    list = dll_remove_list(list);
+    assert(list == NULL);
 }
 
 void test_searching_nodes() {
     printf("%s\ntest_searching_nodes%s\n", GRN, reset);
     printf("*** making dll list of 3\n");
-    my_dll* head = dll_make_list(content_make(test_str_node_1_0));
-    dll_append_node(head, dll_make_node(content_make(test_str_node_2_0)));
-    dll_append_node(head, dll_make_node(content_make(test_str_node_3_0)));
-    assert(dll_size(head) == 3);
-    dll_print_list(head);
-    dll_print_list_reverse(head);
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_2_0)));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_3_0)));
+    assert(dll_size(list) == 3);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
 
     printf("searching %s\n", test_str_node_1_0);
     my_content* search_content = content_make(test_str_node_1_0);
-    my_dll* searching_node = dll_search_node(head, search_content);
+    my_dll* searching_node = dll_search_node(list, search_content);
     assert(searching_node != NULL);
     assert(content_equals(searching_node->content, search_content));
 
     printf("searching %s\n", test_str_node_2_0);
     content_free(search_content);
     search_content = content_make(test_str_node_2_0);
-    searching_node = dll_search_node(head, search_content);
+    searching_node = dll_search_node(list, search_content);
     assert(searching_node != NULL);
     assert(content_equals(searching_node->content, search_content));
 
     printf("searching %s\n", test_str_node_3_0);
     content_free(search_content);
     search_content = content_make(test_str_node_3_0);
-    searching_node = dll_search_node(head, search_content);
+    searching_node = dll_search_node(list, search_content);
     assert(searching_node != NULL);
     assert(content_equals(searching_node->content, search_content));
 
     printf("*** removing the list\n");
-    head = dll_remove_list(head);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_remove_list(list);
+    assert(list == NULL);
+    dll_print_list(list);
 }
 
 void test_inserting_nodes() {
     printf("%s\ntest_inserting_nodes%s\n", GRN, reset);
     printf("*** making dll list of 3\n");
-    my_dll* head = dll_make_list(content_make(test_str_node_1_0));
-    dll_append_node(head, dll_make_node(content_make(test_str_node_2_0)));
-    dll_append_node(head, dll_make_node(content_make(test_str_node_3_0)));
-    assert(dll_size(head) == 3);
-    dll_print_list(head);
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_2_0)));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_3_0)));
+    assert(dll_size(list) == 3);
+    dll_print_list(list);
 
     printf("inserting a new node 1.5\n");
-    my_dll* new_node = dll_make_node(content_make(test_str_node_1_5));
+    my_dll* new_node = dll_make_node(list, content_make(test_str_node_1_5));
     my_content* search_content = content_make(test_str_node_2_0);
-    my_dll* at = dll_search_node(head, search_content);
-    head = dll_insert_node(head, at, new_node);
+    my_dll* at = dll_search_node(list, search_content);
+    dll_insert_node(list, at, new_node);
     content_free(search_content);    
-    assert(dll_size(head) == 4);
-    dll_print_list(head);
+    assert(dll_size(list) == 4);
+    dll_print_list(list);
 
     my_content* next_content = content_make(test_str_node_2_0);
     my_content* prev_content = content_make(test_str_node_1_0);
@@ -477,13 +1475,13 @@ void test_inserting_nodes() {
     content_free(prev_content);
 
     printf("inserting a new node 2.5\n");
-    new_node = dll_make_node(content_make(test_str_node_2_5));
+    new_node = dll_make_node(list, content_make(test_str_node_2_5));
     search_content = content_make(test_str_node_3_0);
-    at = dll_search_node(head, search_content);
-    head = dll_insert_node(head, at, new_node);
+    at = dll_search_node(list, search_content);
+    dll_insert_node(list, at, new_node);
     content_free(search_content);    
-    assert(dll_size(head) == 5);
-    dll_print_list(head);
+    assert(dll_size(list) == 5);
+    dll_print_list(list);
 
     next_content = content_make(test_str_node_3_0);
     prev_content = content_make(test_str_node_2_0);
@@ -494,90 +1492,794 @@ void test_inserting_nodes() {
     content_free(prev_content);
 
     printf("inserting a 0.5 @ head\n");
-    new_node = dll_make_node(content_make(test_str_node_0_5));    
-    head = dll_insert_node(head, head, new_node);    
-    assert(dll_size(head) == 6);
-    dll_print_list(head);
+    new_node = dll_make_node(list, content_make(test_str_node_0_5));    
+    dll_insert_node(list, list->head, new_node);    
+    assert(dll_size(list) == 6);
+    dll_print_list(list);
 
     next_content = content_make(test_str_node_1_0);
     
     assert(new_node->prev_ptr == NULL);
     assert(content_equals(new_node->next_ptr->content, next_content));
     content_free(next_content);
-    dll_print_list_reverse(head);
+    dll_print_list_reverse(list);
 
     printf("*** removing the list\n");
-    head = dll_remove_list(head);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_remove_list(list);
+    assert(list == NULL);
+    dll_print_list(list);
 }
 
 void test_removing_nodes() {
      printf("%s\ntest_removing_nodes%s\n", GRN, reset);
     printf("*** making dll list of 3\n");
-    my_dll* head = dll_make_list(content_make(test_str_node_1_0));
-    dll_append_node(head, dll_make_node(content_make(test_str_node_2_0)));
-    dll_append_node(head, dll_make_node(content_make(test_str_node_3_0)));
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_2_0)));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_3_0)));
 
     printf("inserting a new node 1.5\n");
-    my_dll* new_node = dll_make_node(content_make(test_str_node_1_5));
+    my_dll* new_node = dll_make_node(list, content_make(test_str_node_1_5));
     my_content* search_content = content_make(test_str_node_2_0);
-    my_dll* at = dll_search_node(head, search_content);
-    head = dll_insert_node(head, at, new_node);
+    my_dll* at = dll_search_node(list, search_content);
+    dll_insert_node(list, at, new_node);
     content_free(search_content);    
 
     printf("inserting a new node 2.5\n");
-    new_node = dll_make_node(content_make(test_str_node_2_5));
+    new_node = dll_make_node(list, content_make(test_str_node_2_5));
     search_content = content_make(test_str_node_3_0);
-    at = dll_search_node(head, search_content);
-    head = dll_insert_node(head, at, new_node);
+    at = dll_search_node(list, search_content);
+    dll_insert_node(list, at, new_node);
     content_free(search_content);    
 
     printf("inserting a 0.5 @ head\n");
-    new_node = dll_make_node(content_make(test_str_node_0_5));    
-    head = dll_insert_node(head, head, new_node);    
+    new_node = dll_make_node(list, content_make(test_str_node_0_5));    
+    dll_insert_node(list, list->head, new_node);    
 
-    dll_print_list(head);
-    dll_print_list_reverse(head);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
 
     printf("removing 0.5\n");
     search_content = content_make(test_str_node_0_5);
     my_content* cur_content = content_make(test_str_node_1_0);
-    at = dll_search_node(head, search_content);
-    head = dll_remove_node(head, at);
-    assert(dll_size(head) == 5);
-    assert(content_equals(head->content, cur_content));
+    at = dll_search_node(list, search_content);
+    dll_remove_node(list, at);
+    assert(dll_size(list) == 5);
+    assert(content_equals(list->head->content, cur_content));
     content_free(cur_content);
     content_free(search_content);
-    dll_free_node(at);
-    dll_print_list(head);
-    dll_print_list_reverse(head);
+    dll_free_node(list, at);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
 
     printf("removing 2.5\n");
     search_content = content_make(test_str_node_2_5);
-    at = dll_search_node(head, search_content);
-    head = dll_remove_node(head, at);
-    assert(dll_size(head) == 4);
-    dll_free_node(at);
+    at = dll_search_node(list, search_content);
+    dll_remove_node(list, at);
+    assert(dll_size(list) == 4);
+    dll_free_node(list, at);
     content_free(search_content);
-    dll_print_list(head);
-    dll_print_list_reverse(head);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
 
     printf("removing 1.5\n");
     search_content = content_make(test_str_node_1_5);
-    at = dll_search_node(head, search_content);
-    head = dll_remove_node(head, at);
-    assert(dll_size(head) == 3);
-    dll_free_node(at);
+    at = dll_search_node(list, search_content);
+    dll_remove_node(list, at);
+    assert(dll_size(list) == 3);
+    dll_free_node(list, at);
+    content_free(search_content);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
+
+    printf("removing 3.0 (the last node)\n");
+    search_content = content_make(test_str_node_3_0);
+    cur_content = content_make(test_str_node_2_0);
+    at = dll_search_node(list, search_content);
+    dll_remove_node(list, at);
+    assert(dll_size(list) == 2);
+    assert(content_equals(dll_get_last_node(list)->content, cur_content));
+    assert(dll_get_last_node(list)->next_ptr == NULL);
+    dll_free_node(list, at);
+    content_free(cur_content);
     content_free(search_content);
-    dll_print_list(head);
-    dll_print_list_reverse(head);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
 
     printf("*** removing the list\n");
-    head = dll_remove_list(head);
-    assert(head == NULL);
-    dll_print_list(head);
+    list = dll_remove_list(list);
+    assert(list == NULL);
+    dll_print_list(list);
+}
+void test_pooled_nodes() {
+    printf("%s\ntest_pooled_nodes%s\n", GRN, reset);
+    printf("*** making dll list on a pool of 2 nodes per block\n");
+    list_pool* pool = list_pool_make(sizeof(my_dll), 2);
+    my_dll_list* list = dll_make_list_with_pool(pool, content_make(test_str_node_1_0));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_2_0)));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_3_0)));
+    assert(dll_size(list) == 3);
+    dll_print_list(list);
+
+    list_pool_stats stats = list_pool_get_stats(pool);
+    assert(stats.blocks_allocated == 2);
+    assert(stats.nodes_live == 3);
+    assert(stats.nodes_recycled == 0);
+
+    printf("*** removed nodes are recycled\n");
+    my_dll* at = list->head->next_ptr;
+    dll_remove_node(list, at);
+    dll_free_node(list, at);
+    assert(list_pool_get_stats(pool).nodes_live == 2);
+
+    my_dll* new_node = dll_make_node(list, content_make(test_str_node_2_5));
+    assert(new_node == at);
+    dll_insert_node(list, dll_get_last_node(list), new_node);
+    stats = list_pool_get_stats(pool);
+    assert(stats.blocks_allocated == 2);
+    assert(stats.nodes_live == 3);
+    assert(stats.nodes_recycled == 1);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
+
+    printf("*** a pool with too small nodes is refused\n");
+    list_pool* small_pool = list_pool_make(sizeof(void*), 0);
+    my_content* content = content_make(test_str_node_1_0);
+    assert(dll_make_list_with_pool(small_pool, content) == NULL);
+    content_free(content);
+    small_pool = list_pool_free(small_pool);
+
+    printf("*** removing the list gives all nodes back\n");
+    list = dll_remove_list(list);
+    assert(list_pool_get_stats(pool).nodes_live == 0);
+    pool = list_pool_free(pool);
+    assert(pool == NULL);
 }
+
+void test_text_nodes() {
+    printf("%s\ntest_text_nodes%s\n", GRN, reset);
+    printf("*** node and content in one allocation\n");
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    dll_append_node(list, dll_make_text_node(list, test_str_node_2_0));
+    dll_append_node(list, dll_make_text_node(list, test_str_node_3_0));
+    assert(!dll_node_embeds_content(list->head));
+    assert(dll_node_embeds_content(dll_get_last_node(list)));
+    assert(dll_get_last_node(list)->content->length == strlen(test_str_node_3_0));
+    dll_print_list(list);
+
+    my_content* search_content = content_make(test_str_node_2_0);
+    my_dll* at = dll_search_node(list, search_content);
+    assert(at != NULL && dll_node_embeds_content(at));
+    dll_remove_node(list, at);
+    dll_free_node(list, at);
+    content_free(search_content);
+    assert(dll_size(list) == 2);
+    list = dll_remove_list(list);
+
+    printf("*** small-string mode on a pool\n");
+    list_pool* pool = list_pool_make(DLL_SSO_NODE_SIZE(16), 0);
+    list = dll_make_list_with_pool(pool, content_make(test_str_node_1_0));
+    dll_append_node(list, dll_make_text_node(list, test_str_node_2_0));
+    dll_append_node(list, dll_make_text_node(list, "*** a text too long for the pool node ***"));
+    assert(dll_node_embeds_content(list->head->next_ptr));
+    assert(!dll_node_embeds_content(dll_get_last_node(list)));
+    dll_print_list(list);
+    dll_print_list_reverse(list);
+
+    list = dll_remove_list(list);
+    assert(list_pool_get_stats(pool).nodes_live == 0);
+    pool = list_pool_free(pool);
+}
+
+void test_indexed_search() {
+    printf("%s\ntest_indexed_search%s\n", GRN, reset);
+    printf("*** making dll list of 3 and indexing it\n");
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_2_0)));
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_3_0)));
+    dll_attach_index(list);
+    assert(list->index->count == 3);
+
+    my_content* search_content = content_make(test_str_node_2_0);
+    my_dll* at = dll_search_node(list, search_content);
+    assert(at == list->head->next_ptr);
+
+    printf("*** inserted, prepended and appended nodes are indexed\n");
+    dll_insert_node(list, at, dll_make_node(list, content_make(test_str_node_1_5)));
+    dll_prepend_node(list, dll_make_text_node(list, test_str_node_0_5));
+    dll_append_node(list, dll_make_text_node(list, test_str_node_2_0));
+    assert(list->index->count == dll_size(list));
+    my_content* other_content = content_make(test_str_node_0_5);
+    assert(dll_search_node(list, other_content) == list->head);
+    content_free(other_content);
+    list_index_entry* entry = list_index_find(list->index, search_content);
+    assert(entry != NULL);
+    entry = list_index_find_next(entry, search_content);
+    assert(entry != NULL);
+    assert(list_index_find_next(entry, search_content) == NULL);
+    dll_print_list(list);
+
+    printf("*** removed nodes are not found anymore\n");
+    dll_remove_node(list, at);
+    dll_free_node(list, at);
+    at = dll_search_node(list, search_content);
+    assert(at == dll_get_last_node(list));
+    dll_remove_node(list, at);
+    dll_free_node(list, at);
+    assert(dll_search_node(list, search_content) == NULL);
+    assert(list->index->count == dll_size(list));
+
+    printf("*** clearing the list clears the index\n");
+    dll_clear_list(list);
+    assert(list->index->count == 0);
+    dll_append_node(list, dll_make_node(list, content_make(test_str_node_2_0)));
+    assert(dll_search_node(list, search_content) == list->head);
+
+    dll_detach_index(list);
+    assert(list->index == NULL);
+    assert(dll_search_node(list, search_content) == list->head);
+    content_free(search_content);
+    list = dll_remove_list(list);
+}
+
+void test_status_codes() {
+    printf("%s\ntest_status_codes%s\n", GRN, reset);
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    my_dll* node = dll_make_node(list, content_make(test_str_node_2_0));
+    list_status status = dll_append_node(list, node);
+    assert(status == LIST_OK);
+    status = dll_append_node(NULL, node);
+    assert(status == LIST_ERR_NULL);
+    status = dll_prepend_node(list, NULL);
+    assert(status == LIST_ERR_NULL);
+    status = dll_insert_node(list, NULL, node);
+    assert(status == LIST_ERR_NULL);
+    status = dll_remove_node(list, NULL);
+    assert(status == LIST_ERR_NULL);
+    assert(dll_size(list) == 2);
+
+    printf("*** an empty list has nothing to insert at or remove\n");
+    status = dll_clear_list(list);
+    assert(status == LIST_OK);
+    node = dll_make_text_node(list, test_str_node_1_5);
+    status = dll_insert_node(list, node, node);
+    assert(status == LIST_ERR_NOT_FOUND);
+    status = dll_remove_node(list, node);
+    assert(status == LIST_ERR_NOT_FOUND);
+    printf("status= %s\n", list_status_name(dll_append_node(list, node)));
+    assert(dll_size(list) == 1);
+    list = dll_remove_list(list);
+}
+
+void test_from_array() {
+    printf("%s\ntest_from_array%s\n", GRN, reset);
+    const char* texts[] = { test_str_node_1_0, test_str_node_2_0, test_str_node_3_0 };
+    my_dll_list* list = dll_from_array(texts, 3);
+    assert(dll_size(list) == 3);
+    assert(strcmp(list->head->content->text, test_str_node_1_0) == 0);
+    assert(strcmp(list->tail->content->text, test_str_node_3_0) == 0);
+    assert(list->tail->prev_ptr->prev_ptr == list->head);
+    assert(dll_node_embeds_content(list->tail));
+    dll_print_list(list);
+    dll_print_list_reverse(list);
+
+    printf("*** arena nodes and malloc'ed nodes mix\n");
+    dll_insert_node(list, list->tail, dll_make_text_node(list, test_str_node_2_5));
+    assert(!list_arena_owns(list->arena, list->tail->prev_ptr));
+    my_content* search_content = content_make(test_str_node_2_0);
+    my_dll* node = dll_search_node(list, search_content);
+    dll_remove_node(list, node);
+    dll_free_node(list, node);
+    assert(dll_search_node(list, search_content) == NULL);
+    assert(dll_size(list) == 3);
+    content_free(search_content);
+    dll_print_list(list);
+    list = dll_remove_list(list);
+
+    printf("*** an empty array makes an empty list\n");
+    list = dll_from_array(NULL, 0);
+    assert(dll_size(list) == 0 && list->head == NULL && list->arena == NULL);
+    list = dll_remove_list(list);
+
+    const char* bad_texts[] = { test_str_node_1_0, NULL };
+    list = dll_from_array(bad_texts, 2);
+    assert(list == NULL);
+}
+
+/**
+ * @brief checking that the list is sorted both ways and that the towers
+ * of the skip list only hold nodes of the list, in order.
+ * 
+ */
+void test_check_sorted(my_dll_list* list) {
+    size_t count = 0;
+    for (my_dll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        assert(cur->prev_ptr == NULL || content_compare(cur->prev_ptr->content, cur->content) <= 0);
+        assert(cur->next_ptr != NULL || cur == list->tail);
+        assert(cur->next_ptr == NULL || cur->next_ptr->prev_ptr == cur);
+        count++;
+    }
+    assert(count == dll_size(list));
+    for (size_t l = 0; l < list->skip->level; l++) {
+        for (list_skip_tower* tower = list->skip->heads[l]; tower != NULL; tower = tower->next[l]) {
+            assert(tower->height > l);
+            assert(tower->content == ((my_dll*)tower->node)->content);
+            assert(tower->next[l] == NULL || content_compare(tower->content, tower->next[l]->content) <= 0);
+        }
+    }
+}
+
+void test_skip_list() {
+    printf("%s\ntest_skip_list%s\n", GRN, reset);
+    printf("*** attaching a skip list sorts the list\n");
+    const char* texts[] = { test_str_node_3_0, test_str_node_1_0, test_str_node_2_0, test_str_node_1_0 };
+    my_dll_list* list = dll_from_array(texts, 4);
+    my_dll* first_1_0 = list->head->next_ptr;
+    list_status status = dll_attach_skip(list);
+    assert(status == LIST_OK);
+    test_check_sorted(list);
+    assert(list->head == first_1_0);
+    assert(strcmp(list->tail->content->text, test_str_node_3_0) == 0);
+    dll_print_list(list);
+    dll_print_list_reverse(list);
+
+    printf("*** inserting in order, and refusing nodes out of order\n");
+    status = dll_insert_sorted(list, dll_make_text_node(list, test_str_node_2_5));
+    assert(status == LIST_OK);
+    status = dll_insert_sorted(list, dll_make_text_node(list, test_str_node_0_5));
+    assert(status == LIST_OK);
+    assert(strcmp(list->head->content->text, test_str_node_0_5) == 0);
+    my_dll* node = dll_make_text_node(list, test_str_node_1_5);
+    status = dll_append_node(list, node);
+    assert(status == LIST_ERR_ORDER);
+    status = dll_prepend_node(list, node);
+    assert(status == LIST_ERR_ORDER);
+    status = dll_insert_node(list, list->tail, node);
+    assert(status == LIST_ERR_ORDER);
+    my_content* search_content = content_make(test_str_node_2_0);
+    status = dll_insert_node(list, dll_search_node(list, search_content), node);
+    assert(status == LIST_OK);
+    assert(dll_size(list) == 7);
+    test_check_sorted(list);
+
+    printf("*** searching and ranges\n");
+    my_content* from = content_make(test_str_node_1_0);
+    my_content* to = content_make(test_str_node_2_0);
+    assert(dll_search_node(list, from) == first_1_0);
+    size_t in_range = 0;
+    for (my_dll* cur = dll_lower_bound(list, from); cur != dll_upper_bound(list, to); cur = cur->next_ptr) {
+        printf("in range: %s\n", cur->content->text);
+        in_range++;
+    }
+    assert(in_range == 4);
+    assert(dll_upper_bound(list, list->tail->content) == NULL);
+    assert(dll_lower_bound(list, list->head->content) == list->head);
+
+    printf("*** removing keeps the towers up to date\n");
+    node = dll_search_node(list, search_content);
+    dll_remove_node(list, node);
+    dll_free_node(list, node);
+    assert(dll_search_node(list, search_content) == NULL);
+    test_check_sorted(list);
+    content_free(search_content);
+    content_free(from);
+    content_free(to);
+    list = dll_remove_list(list);
+
+    printf("*** a large list keeps O(log n) towers\n");
+    list = dll_from_array(NULL, 0);
+    dll_attach_skip(list);
+    char buf[32];
+    for (int i = 0; i < 10000; i++) {
+        snprintf(buf, sizeof(buf), "key-%05d", (i * 7919) % 10000);
+        dll_insert_sorted(list, dll_make_text_node(list, buf));
+    }
+    test_check_sorted(list);
+    assert(list->skip->level > 2 && list->skip->level < LIST_SKIP_MAX_LEVEL);
+    printf("towers= %zu levels= %zu\n", list->skip->count, list->skip->level);
+    for (int i = 0; i < 10000; i += 2) {
+        snprintf(buf, sizeof(buf), "key-%05d", i);
+        search_content = content_make(buf);
+        node = dll_search_node(list, search_content);
+        assert(node != NULL && content_equals(node->content, search_content));
+        dll_remove_node(list, node);
+        dll_free_node(list, node);
+        content_free(search_content);
+    }
+    test_check_sorted(list);
+    assert(dll_size(list) == 5000);
+    dll_detach_skip(list);
+    assert(list->skip == NULL);
+    list = dll_remove_list(list);
+}
+
+/**
+ * @brief sorting by length, longest first; equal lengths keep their
+ * order.
+ * 
+ */
+int test_longer_first(const my_content* c1, const my_content* c2) {
+    return (c1->length < c2->length) - (c1->length > c2->length);
+}
+
+/**
+ * @brief the texts of the list, checked in both directions.
+ * 
+ */
+void test_check_texts(my_dll_list* list, const char* const* texts, size_t count) {
+    assert(dll_size(list) == count);
+    size_t i = 0;
+    for (my_dll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        assert(strcmp(cur->content->text, texts[i++]) == 0);
+    }
+    assert(i == count);
+    for (my_dll* cur = list->tail; cur != NULL; cur = cur->prev_ptr) {
+        assert(strcmp(cur->content->text, texts[--i]) == 0);
+    }
+}
+
+void test_sort_and_merge() {
+    printf("%s\ntest_sort_and_merge%s\n", GRN, reset);
+    printf("*** sorting in place\n");
+    const char* texts[] = { "pear", "fig", "apple", "kiwi", "banana", "fig" };
+    my_dll_list* list = dll_from_array(texts, 6);
+    my_dll* first_fig = list->head->next_ptr;
+    list_status status = dll_sort(list, NULL);
+    assert(status == LIST_OK);
+    test_check_texts(list, (const char*[]){ "apple", "banana", "fig", "fig", "kiwi", "pear" }, 6);
+    assert(list->head->next_ptr->next_ptr == first_fig);
+    dll_print_list(list);
+
+    printf("*** sorting with a comparator, stable\n");
+    status = dll_sort(list, test_longer_first);
+    assert(status == LIST_OK);
+    test_check_texts(list, (const char*[]){ "banana", "apple", "kiwi", "pear", "fig", "fig" }, 6);
+    assert(list->tail->prev_ptr == first_fig);
+    dll_print_list_reverse(list);
+    dll_sort(list, NULL);
+
+    printf("*** merging two sorted lists\n");
+    const char* more_texts[] = { "cherry", "fig", "zucchini" };
+    my_dll_list* other = dll_from_array(more_texts, 3);
+    status = dll_merge(list, other, NULL);
+    assert(status == LIST_OK);
+    test_check_texts(list, (const char*[]){ "apple", "banana", "cherry", "fig", "fig", "fig", "kiwi", "pear",
+        "zucchini" }, 9);
+    assert(dll_size(other) == 0 && other->head == NULL && other->tail == NULL && other->arena == NULL);
+    assert(list_arena_owns(list->arena, list->tail));
+    dll_print_list(list);
+
+    printf("*** merging into a list with a skip list\n");
+    dll_attach_skip(list);
+    const char* last_texts[] = { "apricot", "grape" };
+    dll_remove_list(other);
+    other = dll_from_array(last_texts, 2);
+    status = dll_merge(list, other, test_longer_first);
+    assert(status == LIST_ERR_ORDER);
+    status = dll_sort(list, test_longer_first);
+    assert(status == LIST_ERR_ORDER);
+    status = dll_merge(list, other, NULL);
+    assert(status == LIST_OK);
+    test_check_sorted(list);
+    my_content* search_content = content_make("grape");
+    assert(dll_search_node(list, search_content) != NULL);
+    content_free(search_content);
+
+    status = dll_sort(NULL, NULL);
+    assert(status == LIST_ERR_NULL);
+    status = dll_merge(NULL, list, NULL);
+    assert(status == LIST_ERR_NULL);
+    dll_remove_list(other);
+    list = dll_remove_list(list);
+}
+
+void test_save_and_load() {
+    printf("%s\ntest_save_and_load%s\n", GRN, reset);
+    char path[] = "/tmp/dll-file-XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    printf("*** a round trip through a temp file\n");
+    const char* texts[] = { test_str_node_1_0, test_str_node_2_0, "", test_str_node_3_0 };
+    my_dll_list* list = dll_from_array(texts, 4);
+    list_status status = dll_save(list, path);
+    assert(status == LIST_OK);
+    list = dll_remove_list(list);
+
+    list = dll_load(path);
+    assert(list != NULL);
+    test_check_texts(list, texts, 4);
+    for (my_dll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        assert(list_file_owns(list->file, cur->content));
+    }
+    dll_print_list(list);
+    dll_print_list_reverse(list);
+
+    printf("*** the loaded list can be changed, sorted and saved again\n");
+    my_content* search_content = content_make("");
+    my_dll* at = dll_search_node(list, search_content);
+    dll_remove_node(list, at);
+    dll_free_node(list, at);
+    content_free(search_content);
+    dll_prepend_node(list, dll_make_text_node(list, test_str_node_2_5));
+    dll_sort(list, NULL);
+    status = dll_save(list, path);
+    assert(status == LIST_OK);
+    list = dll_remove_list(list);
+    list = dll_load(path);
+    test_check_texts(list, (const char*[]){ test_str_node_1_0, test_str_node_2_0, test_str_node_2_5,
+        test_str_node_3_0 }, 4);
+    list = dll_remove_list(list);
+
+    printf("*** a damaged file is refused\n");
+    // a hash that does not match its text, in the first record.
+    FILE* file = fopen(path, "r+b");
+    uint64_t hash;
+    fseek(file, sizeof(list_file_header) + offsetof(my_content, hash), SEEK_SET);
+    size_t read = fread(&hash, sizeof(hash), 1, file);
+    assert(read == 1);
+    uint64_t bad_hash = hash ^ 1;
+    fseek(file, sizeof(list_file_header) + offsetof(my_content, hash), SEEK_SET);
+    fwrite(&bad_hash, sizeof(bad_hash), 1, file);
+    fflush(file);
+    list = dll_load(path);
+    assert(list == NULL);
+    fseek(file, sizeof(list_file_header) + offsetof(my_content, hash), SEEK_SET);
+    fwrite(&hash, sizeof(hash), 1, file);
+    fclose(file);
+    list = dll_load(path);
+    assert(list != NULL);
+    list = dll_remove_list(list);
+    file = fopen(path, "r+b");
+    fseek(file, -8, SEEK_END);
+    uint64_t bad_offset = 12345;
+    fwrite(&bad_offset, sizeof(bad_offset), 1, file);
+    fclose(file);
+    list = dll_load(path);
+    assert(list == NULL);
+    // an offset that wraps around when the content header is added.
+    file = fopen(path, "r+b");
+    fseek(file, -8, SEEK_END);
+    bad_offset = UINT64_MAX - LIST_FILE_ALIGN + 1;
+    fwrite(&bad_offset, sizeof(bad_offset), 1, file);
+    fclose(file);
+    list = dll_load(path);
+    assert(list == NULL);
+    truncate(path, 16);
+    list = dll_load(path);
+    assert(list == NULL);
+
+    printf("*** an empty list makes a file without records\n");
+    list = dll_from_array(NULL, 0);
+    status = dll_save(list, path);
+    assert(status == LIST_OK);
+    list = dll_remove_list(list);
+    list = dll_load(path);
+    assert(list != NULL && dll_size(list) == 0 && list->head == NULL);
+    list = dll_remove_list(list);
+    unlink(path);
+    list = dll_load(path);
+    assert(list == NULL);
+}
+
+list_status test_sum_batch(my_dll_list* list, void* context) {
+    size_t* sum = context;
+    for (my_dll* cur = list->tail; cur != NULL; cur = cur->prev_ptr) {
+        *sum += strtoul(cur->content->text, NULL, 10);
+    }
+    // the callback may change the batch.
+    dll_remove_node(list, list->head);
+    return LIST_OK;
+}
+
+void test_from_stream() {
+    printf("%s\ntest_from_stream%s\n", GRN, reset);
+    printf("*** reading lines from a pipe\n");
+    int fds[2];
+    int result = pipe(fds);
+    assert(result == 0);
+    const char input[] = "*** Node 1.0 ***\n*** Node 2.0 ***\r\n*** Node 3.0 ***\n";
+    ssize_t written = write(fds[1], input, sizeof(input) - 1);
+    assert(written == sizeof(input) - 1);
+    close(fds[1]);
+    my_dll_list* list = dll_from_stream(fds[0]);
+    close(fds[0]);
+    test_check_texts(list, (const char*[]){ test_str_node_1_0, test_str_node_2_0, test_str_node_3_0 }, 3);
+    dll_print_list_reverse(list);
+    list = dll_remove_list(list);
+
+    printf("*** 1000 numbers in batches of 64\n");
+    result = pipe(fds);
+    assert(result == 0);
+    FILE* out = fdopen(fds[1], "w");
+    for (int i = 1; i <= 1000; i++) {
+        fprintf(out, "%d\n", i);
+    }
+    fclose(out);
+    size_t sum = 0;
+    list_status status = dll_stream_batches(fds[0], 64, test_sum_batch, &sum);
+    assert(status == LIST_OK);
+    close(fds[0]);
+    assert(sum == 500500);
+    printf("sum= %zu\n", sum);
+}
+
+/**
+ * @brief reading back everything written to a file.
+ * 
+ */
+size_t test_read_back(FILE* file, char* buf, size_t size) {
+    rewind(file);
+    size_t length = fread(buf, 1, size - 1, file);
+    buf[length] = '\0';
+    return length;
+}
+
+void test_write_list() {
+    printf("%s\ntest_write_list%s\n", GRN, reset);
+    const char* texts[] = { test_str_node_1_0, test_str_node_2_0 };
+    my_dll_list* list = dll_from_array(texts, 2);
+    char buf[256];
+
+    printf("*** writing to a FILE* without colors\n");
+    FILE* file = tmpfile();
+    list_writer writer;
+    list_writer_init_file(&writer, file, LIST_COLOR_NEVER);
+    list_status status = dll_write_list(list, &writer);
+    assert(status == LIST_OK);
+    status = dll_write_list_reverse(list, &writer);
+    assert(status == LIST_OK);
+    status = dll_write_list(NULL, &writer);
+    assert(status == LIST_OK);
+    assert(ftell(file) == 0);
+    status = list_writer_release(&writer);
+    assert(status == LIST_OK);
+    test_read_back(file, buf, sizeof(buf));
+    assert(strcmp(buf, "1. *** Node 1.0 ***\n2. *** Node 2.0 ***\n>>> list size: 2\n"
+        "printing list in reverse order...\n2. *** Node 2.0 ***\n1. *** Node 1.0 ***\n>>> list size: 2\n"
+        ">>> list is empty!\n") == 0);
+    fclose(file);
+
+    printf("*** writing to a file descriptor with colors\n");
+    int fds[2];
+    int result = pipe(fds);
+    assert(result == 0);
+    list_writer_init_fd(&writer, fds[1], LIST_COLOR_ALWAYS);
+    dll_write_list_reverse(list, &writer);
+    status = list_writer_release(&writer);
+    assert(status == LIST_OK);
+    close(fds[1]);
+    ssize_t length = read(fds[0], buf, sizeof(buf) - 1);
+    close(fds[0]);
+    buf[length] = '\0';
+    assert(strncmp(buf, YEL "printing list in reverse order..." reset "\n2. ", 48) == 0);
+
+    printf("*** a text larger than the buffer\n");
+    char* text = malloc(LIST_WRITER_BUFFER + 100);
+    memset(text, 'x', LIST_WRITER_BUFFER + 99);
+    text[LIST_WRITER_BUFFER + 99] = '\0';
+    dll_append_node(list, dll_make_text_node(list, text));
+    file = tmpfile();
+    list_writer_init_file(&writer, file, LIST_COLOR_NEVER);
+    for (int i = 0; i < 100; i++) {
+        dll_write_list(list, &writer);
+    }
+    status = list_writer_release(&writer);
+    assert(status == LIST_OK);
+    size_t one = 2 * 20 + (3 + LIST_WRITER_BUFFER + 99 + 1) + strlen(">>> list size: 3\n");
+    assert((size_t)ftell(file) == 100 * one);
+    result = fseek(file, -(long)(LIST_WRITER_BUFFER + 99 + 1 + strlen(">>> list size: 3\n")), SEEK_END);
+    assert(result == 0);
+    assert(fgetc(file) == 'x');
+    fclose(file);
+    free(text);
+
+    printf("*** a failed write is reported\n");
+    list_writer_init_fd(&writer, -1, LIST_COLOR_AUTO);
+    assert(!writer.color);
+    dll_write_list(list, &writer);
+    status = list_writer_release(&writer);
+    assert(status == LIST_ERR_IO);
+    status = dll_write_list(list, NULL);
+    assert(status == LIST_ERR_NULL);
+    list = dll_remove_list(list);
+}
+
+void test_trace() {
+    printf("%s\ntest_trace%s\n", GRN, reset);
+    list_trace_reset();
+    my_dll_list* list = dll_make_list(content_make(test_str_node_1_0));
+    char text[32];
+    for (int i = 0; i < 200; i++) {
+        snprintf(text, sizeof(text), "*** Node %d ***", i);
+        dll_append_node(list, dll_make_text_node(list, text));
+    }
+    my_content* search_content = content_make(test_str_node_1_0);
+    for (int i = 0; i < 50; i++) {
+        assert(dll_search_node(list, search_content) == list->head);
+    }
+    my_dll* at = dll_search_node(list, search_content);
+    dll_insert_node(list, at->next_ptr, dll_make_text_node(list, test_str_node_1_5));
+    dll_prepend_node(list, dll_make_text_node(list, test_str_node_1_5));
+    dll_remove_node(list, at);
+    dll_free_node(list, at);
+    content_free(search_content);
+    dll_clear_list(list);
+    list = dll_remove_list(list);
+    list_trace_dump(stdout);
+
+    if (list_trace_enabled()) {
+        // 9 appends on a list of < 10 nodes, 90 on < 100, 101 on < 1000.
+        assert(list_trace_count(LIST_TRACE_APPEND, 0) == 9);
+        assert(list_trace_count(LIST_TRACE_APPEND, 1) == 90);
+        assert(list_trace_count(LIST_TRACE_APPEND, 2) == 101);
+        assert(list_trace_count(LIST_TRACE_SEARCH, 2) == 51);
+        assert(list_trace_count(LIST_TRACE_INSERT, 2) == 2);
+        assert(list_trace_count(LIST_TRACE_REMOVE, 2) == 1);
+        // the clear once, not again inside dll_remove_list of the empty list.
+        assert(list_trace_count(LIST_TRACE_REMOVE_ALL, 2) == 1);
+        assert(list_trace_count(LIST_TRACE_REMOVE_ALL, 0) == 1);
+        double p50 = list_trace_percentile(LIST_TRACE_SEARCH, 2, 0.5);
+        assert(p50 > 0 && p50 <= list_trace_percentile(LIST_TRACE_SEARCH, 2, 0.999));
+    }
+    assert(list_trace_bucket(3) == 3 && list_trace_bucket(4) == 4 && list_trace_bucket(7) == 7);
+    assert(list_trace_bucket(8) == 8 && list_trace_bucket(12) == 10 && list_trace_bucket(UINT64_MAX) == 251);
+    assert(list_trace_size(9) == 0 && list_trace_size(10) == 1 && list_trace_size((size_t)-1) == 7);
+    list_trace_reset();
+    assert(list_trace_count(LIST_TRACE_APPEND, 1) == 0);
+}
+
+void test_arena_list() {
+    printf("%s\ntest_arena_list%s\n", GRN, reset);
+    my_dll_list* list = dll_make_arena_list(0);
+    assert(dll_size(list) == 0 && list->arena_mode);
+    dll_append_node(list, dll_make_text_node(list, test_str_node_1_0));
+    dll_append_node(list, dll_make_text_node(list, test_str_node_2_0));
+    dll_append_node(list, dll_make_text_node(list, test_str_node_3_0));
+    assert(list_arena_owns(list->arena, list->head) && dll_node_embeds_content(list->head->next_ptr));
+    my_content* content = content_make(test_str_node_2_5);
+    assert(dll_make_node(list, content) == NULL);
+    content_free(content);
+    assert(dll_size(list) == 3 && list->loose == 0);
+    dll_print_list(list);
+
+    printf("*** removing gives nothing back until the list is cleared\n");
+    my_dll* node = list->head->next_ptr;
+    dll_remove_node(list, node);
+    dll_free_node(list, node);
+    assert(dll_size(list) == 2 && strcmp(list->tail->prev_ptr->content->text, test_str_node_1_0) == 0);
+
+    printf("*** a malloc'ed node is freed on its own\n");
+    dll_append_node(list, dll_make_text_node(NULL, test_str_node_2_5));
+    assert(list->loose == 1);
+    dll_clear_list(list);
+    assert(dll_size(list) == 0 && list->loose == 0 && list->arena != NULL);
+
+    printf("*** a cleared list reuses its arena\n");
+    char* block = (char*)list->arena->blocks;
+    char text[32];
+    for (int i = 0; i < 10000; i++) {
+        snprintf(text, sizeof(text), "*** Node %d ***", i);
+        dll_append_node(list, dll_make_text_node(list, text));
+    }
+    assert(dll_size(list) == 10000 && list->loose == 0);
+    assert(list->arena->blocks->next_ptr != NULL);
+    dll_clear_list(list);
+    assert(list->arena->blocks->next_ptr == NULL && (char*)list->arena->blocks != block);
+    dll_append_node(list, dll_make_text_node(list, test_str_node_1_0));
+    assert(list_arena_owns(list->arena, list->head));
+
+    printf("*** merging arena lists\n");
+    const char* texts[] = { test_str_node_2_0, test_str_node_3_0 };
+    my_dll_list* other = dll_from_array(texts, 2);
+    list_status status = dll_merge(list, other, NULL);
+    assert(status == LIST_OK);
+    assert(dll_size(list) == 3 && list->loose == 0);
+    dll_append_node(other, dll_make_text_node(other, test_str_node_1_5));
+    other = dll_remove_list(other);
+    list = dll_remove_list(list);
+}
+
 /**
  * @brief running test code for using functions above.
  * 
@@ -589,11 +2291,25 @@ int main(int argc, char* argv[]) {
     printf("%s---> STARTS!%s\n", RED, reset);
     test_making_dll();
     test_appending_nodes();
+    test_prepending_nodes();
     test_searching_nodes();
     test_inserting_nodes();
     test_removing_nodes();
+    test_pooled_nodes();
+    test_text_nodes();
+    test_indexed_search();
+    test_status_codes();
+    test_from_array();
+    test_skip_list();
+    test_sort_and_merge();
+    test_save_and_load();
+    test_from_stream();
+    test_write_list();
+    test_trace();
+    test_arena_list();
     printf("%s",RED);
     printf("%s\n---> ENDS!%s\n", RED, reset);
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
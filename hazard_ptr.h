@@ -0,0 +1,222 @@
+#ifndef HAZARD_PTR_H
+#define HAZARD_PTR_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * @brief Hazard pointers, for freeing nodes of lock-free structures.
+ * A thread that is about to read a node publishes its address in one of
+ * its hazard slots (hp_protect). A node that was unlinked is not freed
+ * right away but retired (hp_retire); it is freed by a later scan once
+ * no hazard slot of any thread points at it.
+ *
+ * Every thread working on a structure takes a hp_thread record of the
+ * structure's domain with hp_thread_enter and gives it back with
+ * hp_thread_leave. At most HP_MAX_THREADS threads can be in a domain at
+ * the same time.
+ *
+ */
+#define HP_MAX_THREADS 32
+#define HP_PER_THREAD 3
+#define HP_RETIRE_THRESHOLD (2 * HP_MAX_THREADS * HP_PER_THREAD)
+
+typedef void (*hp_reclaim_fn)(void* node);
+
+typedef struct hp_retired {
+    void* node;
+    hp_reclaim_fn reclaim;
+} hp_retired;
+
+/**
+ * @brief One thread's hazard slots and the nodes it retired. A record
+ * that is given back keeps the nodes that could not be freed yet; the
+ * next thread to take the record frees them in its scans.
+ *
+ */
+typedef struct hp_thread {
+    _Alignas(64) atomic_bool active;
+    _Atomic(void*) hazards[HP_PER_THREAD];
+    size_t retired_count;
+    hp_retired retired[HP_RETIRE_THRESHOLD];
+} hp_thread;
+
+typedef struct hp_domain {
+    hp_thread threads[HP_MAX_THREADS];
+} hp_domain;
+
+static inline hp_domain* hp_domain_make() {
+    hp_domain* domain = aligned_alloc(64, sizeof(hp_domain));
+    for (size_t i = 0; i < HP_MAX_THREADS; i++) {
+        hp_thread* thread = &domain->threads[i];
+        atomic_init(&thread->active, false);
+        for (size_t h = 0; h < HP_PER_THREAD; h++) {
+            atomic_init(&thread->hazards[h], NULL);
+        }
+        thread->retired_count = 0;
+    }
+    return domain;
+}
+
+/**
+ * @brief taking a free thread record of the domain.
+ *
+ * @param domain
+ * @return hp_thread* NULL when HP_MAX_THREADS threads are in already.
+ */
+static inline hp_thread* hp_thread_enter(hp_domain* domain) {
+    for (size_t i = 0; i < HP_MAX_THREADS; i++) {
+        hp_thread* thread = &domain->threads[i];
+        bool expected = false;
+        if (!atomic_load_explicit(&thread->active, memory_order_relaxed) &&
+                atomic_compare_exchange_strong(&thread->active, &expected, true)) {
+            return thread;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief publishing the pointer stored at `source` in hazard slot
+ * `slot`. The pointer is read again until it did not change while it
+ * was being published, so the node cannot have been freed in between.
+ * The low bit (a deletion mark) is kept in the result but not in the
+ * hazard.
+ *
+ * @param thread
+ * @param slot
+ * @param source
+ * @return uintptr_t the value read from source.
+ */
+static inline uintptr_t hp_protect(hp_thread* thread, size_t slot, _Atomic(uintptr_t)* source) {
+    uintptr_t value = atomic_load(source);
+    for (;;) {
+        atomic_store(&thread->hazards[slot], (void*)(value & ~(uintptr_t)1));
+        uintptr_t again = atomic_load(source);
+        if (again == value) {
+            return value;
+        }
+        value = again;
+    }
+}
+
+/**
+ * @brief publishing a pointer that is already protected by another
+ * slot of the same thread, before that slot is reused. No full fence
+ * is needed: a scan reads the slots in order, so when the store is to
+ * a higher slot than the one that protects the node now, a scan that
+ * sees the old slot overwritten also sees this store.
+ *
+ */
+static inline void hp_set(hp_thread* thread, size_t slot, void* node) {
+    atomic_store_explicit(&thread->hazards[slot], node, memory_order_release);
+}
+
+static inline void hp_clear(hp_thread* thread) {
+    for (size_t h = 0; h < HP_PER_THREAD; h++) {
+        atomic_store_explicit(&thread->hazards[h], NULL, memory_order_release);
+    }
+}
+
+static inline int hp_compare_ptr(const void* a, const void* b) {
+    uintptr_t x = (uintptr_t)*(void* const*)a;
+    uintptr_t y = (uintptr_t)*(void* const*)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief freeing the retired nodes of `thread` that no thread of the
+ * domain has a hazard on. The others stay retired.
+ *
+ * @param domain
+ * @param thread
+ */
+static inline void hp_scan(hp_domain* domain, hp_thread* thread) {
+    void* hazards[HP_MAX_THREADS * HP_PER_THREAD];
+    size_t hazard_count = 0;
+    for (size_t i = 0; i < HP_MAX_THREADS; i++) {
+        hp_thread* other = &domain->threads[i];
+        if (!atomic_load(&other->active)) {
+            continue;
+        }
+        for (size_t h = 0; h < HP_PER_THREAD; h++) {
+            void* hazard = atomic_load(&other->hazards[h]);
+            if (hazard != NULL) {
+                hazards[hazard_count++] = hazard;
+            }
+        }
+    }
+    qsort(hazards, hazard_count, sizeof(void*), hp_compare_ptr);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < thread->retired_count; i++) {
+        hp_retired retired = thread->retired[i];
+        if (bsearch(&retired.node, hazards, hazard_count, sizeof(void*), hp_compare_ptr) != NULL) {
+            thread->retired[kept++] = retired;
+        } else {
+            retired.reclaim(retired.node);
+        }
+    }
+    thread->retired_count = kept;
+}
+
+/**
+ * @brief handing over a node that was unlinked and that no thread can
+ * reach from the structure any more. It is freed with `reclaim` once no
+ * hazard points at it.
+ *
+ * @param domain
+ * @param thread
+ * @param node
+ * @param reclaim
+ */
+static inline void hp_retire(hp_domain* domain, hp_thread* thread, void* node, hp_reclaim_fn reclaim) {
+    thread->retired[thread->retired_count].node = node;
+    thread->retired[thread->retired_count].reclaim = reclaim;
+    thread->retired_count++;
+    // a scan keeps at most HP_MAX_THREADS * HP_PER_THREAD nodes, half
+    // of the threshold, so every scan frees at least as many as it keeps.
+    if (thread->retired_count == HP_RETIRE_THRESHOLD) {
+        hp_scan(domain, thread);
+    }
+}
+
+/**
+ * @brief giving a thread record back. Its hazards are cleared and the
+ * nodes it retired are freed if possible.
+ *
+ * @param domain
+ * @param thread
+ */
+static inline void hp_thread_leave(hp_domain* domain, hp_thread* thread) {
+    hp_clear(thread);
+    hp_scan(domain, thread);
+    atomic_store(&thread->active, false);
+}
+
+/**
+ * @brief freeing the domain and every node still retired in it.
+ *
+ * @cond no thread may be in the domain any more.
+ *
+ * @param domain
+ * @return hp_domain* NULL
+ */
+static inline hp_domain* hp_domain_free(hp_domain* domain) {
+    if (domain == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < HP_MAX_THREADS; i++) {
+        hp_thread* thread = &domain->threads[i];
+        for (size_t r = 0; r < thread->retired_count; r++) {
+            thread->retired[r].reclaim(thread->retired[r].node);
+        }
+    }
+    free(domain);
+    return NULL;
+}
+
+#endif
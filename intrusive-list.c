@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ansi_color_codes.h"
+#include "list_pool.h"
+#include "intrusive_list.h"
+
+/**
+ * @brief Example of the intrusive list (intrusive_list.h).
+ * The items below carry their own links and come from a list_pool;
+ * listing them does not allocate anything.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+/**
+ * @brief An item that can be in two lists at once: all items, and the
+ * items that are selected.
+ *
+ */
+typedef struct my_item {
+    int id;
+    char name[24];                  // "item " and any int
+    ilist_link all;
+    ilist_link selected;
+} my_item;
+
+my_item* test_make_item(list_pool* pool, int id) {
+    my_item* item = list_pool_alloc(pool);
+    item->id = id;
+    snprintf(item->name, sizeof(item->name), "item %d", id);
+    return item;
+}
+
+void test_print_ids(ilist* list) {
+    ILIST_FOR_EACH_ENTRY(item, list, my_item, all) {
+        printf("%d. %s\n", item->id, item->name);
+    }
+    printf(">>> list size: %zu\n", ilist_size(list));
+}
+
+/**
+ * @brief the ids of the list in order, checked against `ids`.
+ *
+ */
+void test_check_ids(ilist* list, const int* ids, size_t count) {
+    assert(ilist_size(list) == count);
+    size_t i = 0;
+    ILIST_FOR_EACH_ENTRY(item, list, my_item, all) {
+        assert(item->id == ids[i++]);
+    }
+    assert(i == count);
+    if (count > 0) {
+        assert(ILIST_ENTRY(list->tail, my_item, all)->id == ids[count - 1]);
+    }
+}
+
+void test_appending_and_inserting() {
+    printf("%s\ntest_appending_and_inserting%s\n", GRN, reset);
+    list_pool* pool = list_pool_make(sizeof(my_item), 0);
+    ilist list;
+    ilist_init(&list);
+
+    my_item* one = test_make_item(pool, 1);
+    my_item* three = test_make_item(pool, 3);
+    list_status status = ilist_append(&list, &one->all);
+    assert(status == LIST_OK);
+    status = ilist_append(&list, &three->all);
+    assert(status == LIST_OK);
+    status = ilist_prepend(&list, &test_make_item(pool, 0)->all);
+    assert(status == LIST_OK);
+    test_check_ids(&list, (int[]){ 0, 1, 3 }, 3);
+
+    printf("*** inserting in front of a node\n");
+    status = ilist_insert(&list, &three->all, &test_make_item(pool, 2)->all);
+    assert(status == LIST_OK);
+    status = ilist_insert(&list, list.head, &test_make_item(pool, -1)->all);
+    assert(status == LIST_OK);
+    test_check_ids(&list, (int[]){ -1, 0, 1, 2, 3 }, 5);
+    test_print_ids(&list);
+
+    printf("*** walking backward\n");
+    int id = 3;
+    for (ilist_link* cur = list.tail; cur != NULL; cur = cur->prev_ptr) {
+        assert(ILIST_ENTRY(cur, my_item, all)->id == id--);
+    }
+
+    printf("*** bad arguments\n");
+    status = ilist_append(NULL, &one->all);
+    assert(status == LIST_ERR_NULL);
+    status = ilist_insert(&list, NULL, &one->all);
+    assert(status == LIST_ERR_NULL);
+    ilist empty;
+    ilist_init(&empty);
+    status = ilist_insert(&empty, &one->all, &three->all);
+    assert(status == LIST_ERR_NOT_FOUND);
+
+    // the pool made the items, the list did not allocate anything.
+    assert(list_pool_get_stats(pool).blocks_allocated == 1);
+    pool = list_pool_free(pool);
+}
+
+void test_removing() {
+    printf("%s\ntest_removing%s\n", GRN, reset);
+    list_pool* pool = list_pool_make(sizeof(my_item), 0);
+    ilist list;
+    ilist_init(&list);
+    for (int id = 1; id <= 5; id++) {
+        ilist_append(&list, &test_make_item(pool, id)->all);
+    }
+
+    printf("*** removing the head, the tail and a middle node\n");
+    my_item* head = ILIST_ENTRY(list.head, my_item, all);
+    list_status status = ilist_remove(&list, list.head);
+    assert(status == LIST_OK);
+    assert(head->all.prev_ptr == NULL && head->all.next_ptr == NULL);
+    status = ilist_remove(&list, list.tail);
+    assert(status == LIST_OK);
+    status = ilist_remove(&list, list.head->next_ptr);
+    assert(status == LIST_OK);
+    test_check_ids(&list, (int[]){ 2, 4 }, 2);
+    test_print_ids(&list);
+
+    printf("*** removing while walking\n");
+    ILIST_FOR_EACH_SAFE(cur, next, &list) {
+        ilist_remove(&list, cur);
+        list_pool_release(pool, ILIST_ENTRY(cur, my_item, all));
+    }
+    assert(list.head == NULL && list.tail == NULL);
+    test_check_ids(&list, NULL, 0);
+    status = ilist_remove(&list, &head->all);
+    assert(status == LIST_ERR_NOT_FOUND);
+    pool = list_pool_free(pool);
+}
+
+void test_two_lists() {
+    printf("%s\ntest_two_lists%s\n", GRN, reset);
+    my_item items[6];
+    ilist all;
+    ilist selected;
+    ilist_init(&all);
+    ilist_init(&selected);
+    for (int id = 0; id < 6; id++) {
+        items[id].id = id;
+        snprintf(items[id].name, sizeof(items[id].name), "item %d", id);
+        ilist_append(&all, &items[id].all);
+        if (id % 2 == 0) {
+            ilist_prepend(&selected, &items[id].selected);
+        }
+    }
+
+    printf("*** the same items in both lists\n");
+    test_check_ids(&all, (int[]){ 0, 1, 2, 3, 4, 5 }, 6);
+    int id = 4;
+    ILIST_FOR_EACH_ENTRY(item, &selected, my_item, selected) {
+        assert(item == &items[id]);
+        id -= 2;
+    }
+
+    printf("*** leaving one list keeps the item in the other\n");
+    ilist_remove(&selected, &items[2].selected);
+    assert(ilist_size(&selected) == 2);
+    test_check_ids(&all, (int[]){ 0, 1, 2, 3, 4, 5 }, 6);
+    test_print_ids(&all);
+}
+
+/**
+ * @brief running test code for the intrusive list.
+ *
+ */
+int main(int argc, char* argv[]) {
+    printf("%s---> STARTS!%s\n", RED, reset);
+    test_appending_and_inserting();
+    test_removing();
+    test_two_lists();
+    printf("%s\n---> ENDS!%s\n", RED, reset);
+    return 0;
+}
@@ -0,0 +1,205 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include <stddef.h>
+#include "list_log.h"
+
+/**
+ * @brief An intrusive doubly linked-list.
+ * The links live inside the caller's own struct instead of in a list
+ * node pointing at the payload:
+ *
+ *   typedef struct my_item {
+ *       int id;
+ *       ilist_link link;
+ *   } my_item;
+ *
+ * The list links the ilist_link members and ILIST_ENTRY gets back to
+ * the struct around them (container_of). Nothing in here allocates, so
+ * the objects can come from anywhere (a pool, an array, the stack) and
+ * an object with several links can be in several lists at once.
+ *
+ * Inserting and removing behave like dll_insert_node and
+ * dll_remove_node: insert puts the link in front of `at`, remove
+ * unlinks without freeing anything.
+ *
+ */
+typedef struct ilist_link {
+    struct ilist_link* prev_ptr;
+    struct ilist_link* next_ptr;
+} ilist_link;
+
+typedef struct ilist {
+    ilist_link* head;
+    ilist_link* tail;
+    size_t count;
+} ilist;
+
+/**
+ * @brief the struct of type `type` whose member `member` is the link.
+ *
+ */
+#define ILIST_ENTRY(link, type, member) \
+    ((type*)((char*)(link) - offsetof(type, member)))
+
+/**
+ * @brief same as ILIST_ENTRY, NULL for a NULL link.
+ *
+ */
+#define ILIST_ENTRY_OR_NULL(link, type, member) \
+    ((link) != NULL ? ILIST_ENTRY(link, type, member) : (type*)NULL)
+
+/**
+ * @brief walking the list from head to tail. `cur` is the link.
+ *
+ */
+#define ILIST_FOR_EACH(cur, list) \
+    for (ilist_link* cur = (list)->head; cur != NULL; cur = cur->next_ptr)
+
+/**
+ * @brief walking the list with the structs around the links. `item`
+ * is a `type*`.
+ *
+ */
+#define ILIST_FOR_EACH_ENTRY(item, list, type, member) \
+    for (type* item = ILIST_ENTRY_OR_NULL((list)->head, type, member); item != NULL; \
+         item = ILIST_ENTRY_OR_NULL(item->member.next_ptr, type, member))
+
+/**
+ * @brief walking the list while `cur` may be removed (and freed) in the
+ * loop body; `next` already holds the following link.
+ *
+ */
+#define ILIST_FOR_EACH_SAFE(cur, next, list) \
+    for (ilist_link* cur = (list)->head, *next = cur != NULL ? cur->next_ptr : NULL; cur != NULL; \
+         cur = next, next = cur != NULL ? cur->next_ptr : NULL)
+
+static inline void ilist_init(ilist* list) {
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+}
+
+/**
+ * @brief adding a link at the end of the list.
+ *
+ * @param list
+ * @param link
+ * @return list_status
+ */
+static inline list_status ilist_append(ilist* list, ilist_link* link) {
+    if (list == NULL || link == NULL) {
+        LOG_ERROR("list and/or link is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    link->next_ptr = NULL;
+    link->prev_ptr = list->tail;
+    if (list->tail == NULL) {
+        list->head = link;
+    } else {
+        list->tail->next_ptr = link;
+    }
+    list->tail = link;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief adding a link in front of the list.
+ *
+ * @param list
+ * @param link
+ * @return list_status
+ */
+static inline list_status ilist_prepend(ilist* list, ilist_link* link) {
+    if (list == NULL || link == NULL) {
+        LOG_ERROR("list and/or link is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    link->prev_ptr = NULL;
+    link->next_ptr = list->head;
+    if (list->head == NULL) {
+        list->tail = link;
+    } else {
+        list->head->prev_ptr = link;
+    }
+    list->head = link;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief inserting a link in front of `at`.
+ *
+ * @cond at must be in the list. An empty list gives LIST_ERR_NOT_FOUND.
+ *
+ * @param list
+ * @param at
+ * @param link
+ * @return list_status
+ */
+static inline list_status ilist_insert(ilist* list, ilist_link* at, ilist_link* link) {
+    if (list == NULL || at == NULL || link == NULL) {
+        LOG_ERROR("list or at or link is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->head == NULL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+
+    if (at == list->head) {
+        return ilist_prepend(list, link);
+    }
+
+    link->next_ptr = at;
+    link->prev_ptr = at->prev_ptr;
+    at->prev_ptr->next_ptr = link;
+    at->prev_ptr = link;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief unlinking `at` from the list. The struct around it is not
+ * touched otherwise; its links are cleared.
+ *
+ * @cond at must be in the list. An empty list gives LIST_ERR_NOT_FOUND.
+ *
+ * @param list
+ * @param at
+ * @return list_status
+ */
+static inline list_status ilist_remove(ilist* list, ilist_link* at) {
+    if (list == NULL || at == NULL) {
+        LOG_ERROR("list and/or at is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->head == NULL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+
+    if (at == list->head) {
+        list->head = at->next_ptr;
+    } else {
+        at->prev_ptr->next_ptr = at->next_ptr;
+    }
+
+    if (at == list->tail) {
+        list->tail = at->prev_ptr;
+    } else {
+        at->next_ptr->prev_ptr = at->prev_ptr;
+    }
+
+    at->prev_ptr = NULL;
+    at->next_ptr = NULL;
+    list->count--;
+    return LIST_OK;
+}
+
+static inline size_t ilist_size(const ilist* list) {
+    return list != NULL ? list->count : 0;
+}
+
+#endif
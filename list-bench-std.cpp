@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "list_bench.h"
+#include "my_list.hpp"
+
+using namespace std;
+
+/**
+ * @brief The C++ baselines for list-bench: std::vector<std::string>
+ * and std::list<std::string>, doing what the C lists do in the "ops"
+ * suite. Short texts stay inside std::string (no allocation), like the
+ * text nodes of the C lists keep them inside the node.
+ *
+ * List<T> and DList<T> (my_list.hpp) run the same way, to check the
+ * templates keep up with the C API. They hold a bench_text, so they
+ * search like the C lists and not like the std containers.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+/**
+ * @brief The payload of the C++ lists: the text and its hash, the way
+ * my_content carries them. A search then rejects a node on the hash
+ * and the length before it compares bytes, as content_equals does.
+ * The hash comes first so the reject reads the start of the node.
+ *
+ */
+struct bench_text {
+    size_t hash;
+    string text;
+
+    bench_text(const char* text) : bench_text(string_view(text)) {}
+    explicit bench_text(string_view text) : hash(std::hash<string_view>()(text)), text(text) {}
+};
+
+static bool operator==(const bench_text& a, const bench_text& b)
+{
+    return a.hash == b.hash && a.text == b.text;
+}
+
+/**
+ * @brief What std_search looks for: a string_view for std::string, so
+ * the std containers compare as they are used, and a whole bench_text
+ * (hash included, made once per search) for the C++ lists.
+ *
+ */
+template <typename T>
+struct std_search_key {
+    using type = string_view;
+};
+
+template <>
+struct std_search_key<bench_text> {
+    using type = bench_text;
+};
+
+template <typename Container>
+static void* std_make(const char* const* texts, size_t count)
+{
+    return new Container(texts, texts + count);
+}
+
+template <typename Container>
+static void std_append(void* list, const char* text)
+{
+    static_cast<Container*>(list)->emplace_back(text);
+}
+
+template <typename Container>
+static typename Container::iterator std_middle(Container& container)
+{
+    return next(container.begin(), container.size() / 2);
+}
+
+template <typename Container>
+static void std_insert_middle(void* list, const char* text)
+{
+    Container& container = *static_cast<Container*>(list);
+    container.emplace(std_middle(container), text);
+}
+
+template <typename Container>
+static bool std_search(void* list, const char* text, size_t length)
+{
+    const Container& container = *static_cast<Container*>(list);
+    const typename std_search_key<typename Container::value_type>::type key(string_view(text, length));
+    return find(container.begin(), container.end(), key) != container.end();
+}
+
+template <typename Container>
+static void std_remove_middle(void* list)
+{
+    Container& container = *static_cast<Container*>(list);
+    container.erase(std_middle(container));
+}
+
+/**
+ * @brief List<T> can only insert and remove after a node, so it stops
+ * one node before the middle. With fewer than 2 nodes the middle is
+ * the front, which has no node before it.
+ *
+ */
+template <>
+void std_insert_middle<List<bench_text>>(void* list, const char* text)
+{
+    List<bench_text>& container = *static_cast<List<bench_text>*>(list);
+    if (container.size() < 2) {
+        container.emplace_front(text);
+        return;
+    }
+    container.emplace_after(next(container.begin(), container.size() / 2 - 1), text);
+}
+
+template <>
+void std_remove_middle<List<bench_text>>(void* list)
+{
+    List<bench_text>& container = *static_cast<List<bench_text>*>(list);
+    if (container.size() < 2) {
+        if (container.size() > 0) {
+            container.pop_front();
+        }
+        return;
+    }
+    container.erase_after(next(container.begin(), container.size() / 2 - 1));
+}
+
+template <typename Container>
+static void std_remove_all(void* list)
+{
+    delete static_cast<Container*>(list);
+}
+
+template <typename Container>
+static constexpr bench_target std_target(const char* name)
+{
+    return {
+        name,
+        std_make<Container>,
+        std_append<Container>,
+        std_insert_middle<Container>,
+        std_search<Container>,
+        std_remove_middle<Container>,
+        std_remove_all<Container>,
+    };
+}
+
+const bench_target bench_std_vector = std_target<vector<string>>("vector");
+const bench_target bench_std_list = std_target<list<string>>("list");
+const bench_target bench_cpp_list = std_target<List<bench_text>>("List");
+const bench_target bench_cpp_dlist = std_target<DList<bench_text>>("DList");
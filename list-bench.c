@@ -0,0 +1,1264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "list_bench.h"
+
+/**
+ * @brief Benchmarks for the singly and the doubly linked-list.
+ * The list code is compiled in from the example programs, without
+ * their test code.
+ *
+ * usage: ./list-bench [suite] [max-size]
+ *   suite     index (default), unrolled, build, print, teardown, ops,
+ *             lockfree, concurrent, snapshot
+ *   max-size  largest list size to run, default 10000000
+ *             (lockfree, concurrent, snapshot: the most threads to run,
+ *             default 8)
+ *
+ * The ops suite also writes its results to bench_output.txt, one
+ * tab separated line per target, size and operation. Build with
+ * -DBENCH_STD and list-bench-std.cpp to add the C++ baselines and the
+ * C++ lists of my_list.hpp.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+#define SLL_NO_MAIN
+#define DLL_NO_MAIN
+#define ULL_NO_MAIN
+#define LF_SLL_NO_MAIN
+#define CDLL_NO_MAIN
+#define ADLL_NO_MAIN
+#define PSLL_NO_MAIN
+#include "singly-linked-list.c"
+#include "doubly-linked-list.c"
+#include "unrolled-list.c"
+#include "lockfree-sll.c"
+#include "concurrent-dll.c"
+#include "array-dll.c"
+#include "persistent-sll.c"
+
+#define BENCH_MAX_SIZE 10000000
+#define BENCH_KEYS 1024
+#define BENCH_KEY_SIZE 32
+#define BENCH_OUTPUT "bench_output.txt"
+
+/**
+ * @brief counting the allocations of the code under benchmark. The
+ * allocator functions are replaced for the whole program and forward
+ * to glibc; operator new of the C++ baselines ends up here as well.
+ * Not available with the sanitizers, which replace them themselves.
+ * The counter is bumped from the worker threads of the concurrent
+ * suites too, so it is a relaxed atomic.
+ *
+ */
+static size_t bench_allocs;
+
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define BENCH_NO_ALLOC_COUNT
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define BENCH_NO_ALLOC_COUNT
+#endif
+#endif
+
+static size_t bench_alloc_count() {
+    return __atomic_load_n(&bench_allocs, __ATOMIC_RELAXED);
+}
+
+#if defined(__GLIBC__) && !defined(BENCH_NO_ALLOC_COUNT)
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* memory, size_t size);
+
+void* malloc(size_t size) {
+    __atomic_fetch_add(&bench_allocs, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&bench_allocs, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, size_t size) {
+    __atomic_fetch_add(&bench_allocs, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(memory, size);
+}
+#endif
+
+/**
+ * @brief where timed loops leave their result, so that a -DNDEBUG
+ * build, without the asserts that check it, still runs them.
+ *
+ */
+static volatile size_t bench_sink;
+
+static double bench_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench_key(char* buf, size_t size, size_t i) {
+    snprintf(buf, size, "key-%zu", i);
+}
+
+/**
+ * @brief making search contents for keys spread over the list.
+ * Odd slots are hits, even slots the same keys beyond the end of the
+ * list so they miss.
+ *
+ */
+static my_content** bench_make_keys(size_t size) {
+    my_content** keys = malloc(BENCH_KEYS * sizeof(my_content*));
+    char buf[32];
+    unsigned long long seed = 88172645463325252ULL;
+    for (size_t i = 0; i < BENCH_KEYS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t key = seed % size;
+        bench_key(buf, sizeof(buf), i % 2 ? key : key + size);
+        keys[i] = content_make(buf);
+    }
+    return keys;
+}
+
+static void bench_free_keys(my_content** keys) {
+    for (size_t i = 0; i < BENCH_KEYS; i++) {
+        content_free(keys[i]);
+    }
+    free(keys);
+}
+
+/**
+ * @brief number of lookups for a linear scan, so each size runs for a
+ * similar amount of work.
+ *
+ */
+static size_t bench_scan_lookups(size_t size) {
+    size_t lookups = 50000000 / size;
+    return lookups < 10 ? 10 : lookups;
+}
+
+static void bench_index_report(const char* list, size_t size, const char* method,
+        size_t lookups, size_t found, double ns) {
+    printf("%-4s %10zu  %-6s %9zu lookups  %5.1f%% hits  %12.1f ns/lookup\n",
+        list, size, method, lookups, 100.0 * found / lookups, ns / lookups);
+    fflush(stdout);
+}
+
+static void bench_index_sll(size_t size) {
+    char buf[32];
+    my_sll_list* list = sll_make(content_make("key-0"));
+    for (size_t i = 1; i < size; i++) {
+        bench_key(buf, sizeof(buf), i);
+        sll_append_node(list, sll_make_text_node(list, buf));
+    }
+    my_content** keys = bench_make_keys(size);
+
+    size_t lookups = bench_scan_lookups(size);
+    size_t found = 0;
+    double start = bench_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        found += sll_search(list, keys[i % BENCH_KEYS]) != NULL;
+    }
+    bench_index_report("sll", size, "scan", lookups, found, bench_now_ns() - start);
+
+    sll_attach_index(list);
+    lookups = 1000000;
+    found = 0;
+    start = bench_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        found += sll_search(list, keys[i % BENCH_KEYS]) != NULL;
+    }
+    bench_index_report("sll", size, "index", lookups, found, bench_now_ns() - start);
+
+    bench_free_keys(keys);
+    sll_remove_all(list);
+}
+
+static void bench_index_dll(size_t size) {
+    char buf[32];
+    my_dll_list* list = dll_make_list(content_make("key-0"));
+    for (size_t i = 1; i < size; i++) {
+        bench_key(buf, sizeof(buf), i);
+        dll_append_node(list, dll_make_text_node(list, buf));
+    }
+    my_content** keys = bench_make_keys(size);
+
+    size_t lookups = bench_scan_lookups(size);
+    size_t found = 0;
+    double start = bench_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        found += dll_search_node(list, keys[i % BENCH_KEYS]) != NULL;
+    }
+    bench_index_report("dll", size, "scan", lookups, found, bench_now_ns() - start);
+
+    dll_attach_index(list);
+    lookups = 1000000;
+    found = 0;
+    start = bench_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        found += dll_search_node(list, keys[i % BENCH_KEYS]) != NULL;
+    }
+    bench_index_report("dll", size, "index", lookups, found, bench_now_ns() - start);
+
+    dll_detach_index(list);
+    dll_attach_skip(list);
+    found = 0;
+    start = bench_now_ns();
+    for (size_t i = 0; i < lookups; i++) {
+        found += dll_search_node(list, keys[i % BENCH_KEYS]) != NULL;
+    }
+    bench_index_report("dll", size, "skip", lookups, found, bench_now_ns() - start);
+
+    bench_free_keys(keys);
+    dll_remove_list(list);
+}
+
+/**
+ * @brief hash index lookup against the linear scan, at 1K, 100K and
+ * 10M nodes. The dll is also searched through a skip list.
+ *
+ */
+void bench_index(size_t max_size) {
+    printf("*** search: linear scan vs. hash index vs. skip list\n");
+    for (size_t size = 1000; size <= max_size; size *= 100) {
+        bench_index_sll(size);
+        bench_index_dll(size);
+    }
+}
+
+static void bench_unrolled_report(const char* list, size_t size, const char* op, size_t passes, double ns) {
+    printf("%-4s %10zu  %-8s %8.2f ns/element\n", list, size, op, ns / passes / size);
+    fflush(stdout);
+}
+
+/**
+ * @brief walking every content of a my_dll and of an unrolled list of
+ * the same size, once to sum up the text lengths and once searching
+ * for a text that is not in the list.
+ *
+ */
+void bench_unrolled(size_t max_size) {
+    printf("*** traversal: my_dll vs. unrolled list (%d contents per chunk)\n", ULL_CAPACITY);
+    char buf[32];
+    my_content* missing = content_make("key-missing");
+    for (size_t size = 1000; size <= max_size; size *= 10) {
+        size_t passes = 100000000 / size;
+        passes = passes < 3 ? 3 : passes;
+
+        my_dll_list* dll = dll_make_list(content_make("key-0"));
+        my_ull_list* ull = ull_make_list(content_make("key-0"));
+        for (size_t i = 1; i < size; i++) {
+            bench_key(buf, sizeof(buf), i);
+            dll_append_node(dll, dll_make_node(dll, content_make(buf)));
+            ull_append(ull, content_make(buf));
+        }
+
+        size_t total = 0;
+        double start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            for (my_dll* cur = dll->head; cur != NULL; cur = cur->next_ptr) {
+                total += cur->content->length;
+            }
+        }
+        bench_unrolled_report("dll", size, "walk", passes, bench_now_ns() - start);
+
+        start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            for (my_ull* chunk = ull->head; chunk != NULL; chunk = chunk->next_ptr) {
+                for (size_t i = 0; i < chunk->used; i++) {
+                    total -= chunk->contents[i]->length;
+                }
+            }
+        }
+        bench_unrolled_report("ull", size, "walk", passes, bench_now_ns() - start);
+        assert(total == 0);
+        bench_sink = total;
+
+        size_t found = 0;
+        start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            found += dll_search_node(dll, missing) != NULL;
+        }
+        bench_unrolled_report("dll", size, "search", passes, bench_now_ns() - start);
+
+        start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            found += ull_search(ull, missing).chunk != NULL;
+        }
+        bench_unrolled_report("ull", size, "search", passes, bench_now_ns() - start);
+        assert(found == 0);
+        bench_sink = found;
+
+        dll_remove_list(dll);
+        ull_remove_list(ull);
+    }
+    content_free(missing);
+}
+
+static void bench_build_report(const char* list, size_t size, const char* method, double ns) {
+    printf("%-4s %10zu  %-10s %8.2f ns/node\n", list, size, method, ns / size);
+    fflush(stdout);
+}
+
+/**
+ * @brief building a list from an array of texts, node by node with
+ * content_make + append against sll_from_array / dll_from_array,
+ * loading the same list from a mapped list file (sll_load / dll_load)
+ * and reading it from a file of lines (sll_from_stream /
+ * dll_from_stream). Both files are in the page cache. Freeing the list
+ * is part of the time.
+ *
+ */
+void bench_build(size_t max_size) {
+    printf("*** building: append per text vs. from_array vs. load vs. stream\n");
+    char path[] = "/tmp/list-bench-XXXXXX";
+    char lines_path[] = "/tmp/list-bench-lines-XXXXXX";
+    int fd = mkstemp(path);
+    int lines_fd = mkstemp(lines_path);
+    if (fd < 0 || lines_fd < 0) {
+        printf("cannot create a temp file\n");
+        return;
+    }
+    close(fd);
+    for (size_t size = 1000; size <= max_size; size *= 10) {
+        char* buf = malloc(size * 32);
+        const char** texts = malloc(size * sizeof(char*));
+        for (size_t i = 0; i < size; i++) {
+            bench_key(buf + i * 32, 32, i);
+            texts[i] = buf + i * 32;
+        }
+        FILE* lines = fopen(lines_path, "w");
+        for (size_t i = 0; i < size; i++) {
+            fprintf(lines, "%s\n", texts[i]);
+        }
+        fclose(lines);
+
+        double start = bench_now_ns();
+        my_sll_list* sll = sll_make(content_make(texts[0]));
+        for (size_t i = 1; i < size; i++) {
+            sll_append(sll, content_make(texts[i]));
+        }
+        sll_remove_all(sll);
+        bench_build_report("sll", size, "append", bench_now_ns() - start);
+
+        start = bench_now_ns();
+        sll = sll_from_array(texts, size);
+        sll_remove_all(sll);
+        bench_build_report("sll", size, "from_array", bench_now_ns() - start);
+
+        sll = sll_from_array(texts, size);
+        sll_save(sll, path);
+        sll_remove_all(sll);
+        start = bench_now_ns();
+        sll = sll_load(path);
+        sll_remove_all(sll);
+        bench_build_report("sll", size, "load", bench_now_ns() - start);
+
+        start = bench_now_ns();
+        lseek(lines_fd, 0, SEEK_SET);
+        sll = sll_from_stream(lines_fd);
+        sll_remove_all(sll);
+        bench_build_report("sll", size, "stream", bench_now_ns() - start);
+
+        start = bench_now_ns();
+        my_dll_list* dll = dll_make_list(content_make(texts[0]));
+        for (size_t i = 1; i < size; i++) {
+            dll_append_node(dll, dll_make_node(dll, content_make(texts[i])));
+        }
+        dll_remove_list(dll);
+        bench_build_report("dll", size, "append", bench_now_ns() - start);
+
+        start = bench_now_ns();
+        dll = dll_from_array(texts, size);
+        dll_remove_list(dll);
+        bench_build_report("dll", size, "from_array", bench_now_ns() - start);
+
+        start = bench_now_ns();
+        dll = dll_load(path);
+        dll_remove_list(dll);
+        bench_build_report("dll", size, "load", bench_now_ns() - start);
+
+        start = bench_now_ns();
+        lseek(lines_fd, 0, SEEK_SET);
+        dll = dll_from_stream(lines_fd);
+        dll_remove_list(dll);
+        bench_build_report("dll", size, "stream", bench_now_ns() - start);
+
+        free(texts);
+        free(buf);
+    }
+    close(lines_fd);
+    unlink(path);
+    unlink(lines_path);
+}
+
+/**
+ * @brief the C lists as benchmark targets. Appended and inserted nodes
+ * are text nodes, one allocation per node.
+ *
+ */
+static void* bench_sll_make(const char* const* texts, size_t count) {
+    return sll_from_array(texts, count);
+}
+
+static void bench_sll_append(void* list, const char* text) {
+    sll_append_node(list, sll_make_text_node(list, text));
+}
+
+static my_sll* bench_sll_middle(my_sll_list* list) {
+    my_sll* cur = list->head;
+    for (size_t i = list->count / 2; i > 0; i--) {
+        cur = cur->next_ptr;
+    }
+    return cur;
+}
+
+static void bench_sll_insert_middle(void* list, const char* text) {
+    sll_insert_node(list, bench_sll_middle(list), sll_make_text_node(list, text));
+}
+
+static bool bench_sll_search(void* list, const char* text, size_t length) {
+    _Alignas(my_content) char key[CONTENT_SIZE(BENCH_KEY_SIZE)];
+    return sll_search(list, content_init(key, text, length)) != NULL;
+}
+
+static void bench_sll_remove_middle(void* list) {
+    my_sll* at = bench_sll_middle(list);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+}
+
+static void bench_sll_remove_all(void* list) {
+    sll_remove_all(list);
+}
+
+static const bench_target bench_sll = {
+    "sll", bench_sll_make, bench_sll_append, bench_sll_insert_middle,
+    bench_sll_search, bench_sll_remove_middle, bench_sll_remove_all,
+};
+
+static void* bench_dll_make(const char* const* texts, size_t count) {
+    return dll_from_array(texts, count);
+}
+
+static void bench_dll_append(void* list, const char* text) {
+    dll_append_node(list, dll_make_text_node(list, text));
+}
+
+static my_dll* bench_dll_middle(my_dll_list* list) {
+    my_dll* cur = list->head;
+    for (size_t i = list->count / 2; i > 0; i--) {
+        cur = cur->next_ptr;
+    }
+    return cur;
+}
+
+static void bench_dll_insert_middle(void* list, const char* text) {
+    dll_insert_node(list, bench_dll_middle(list), dll_make_text_node(list, text));
+}
+
+static bool bench_dll_search(void* list, const char* text, size_t length) {
+    _Alignas(my_content) char key[CONTENT_SIZE(BENCH_KEY_SIZE)];
+    return dll_search_node(list, content_init(key, text, length)) != NULL;
+}
+
+static void bench_dll_remove_middle(void* list) {
+    my_dll* at = bench_dll_middle(list);
+    dll_remove_node(list, at);
+    dll_free_node(list, at);
+}
+
+static void bench_dll_remove_all(void* list) {
+    dll_remove_list(list);
+}
+
+static const bench_target bench_dll = {
+    "dll", bench_dll_make, bench_dll_append, bench_dll_insert_middle,
+    bench_dll_search, bench_dll_remove_middle, bench_dll_remove_all,
+};
+
+static void* bench_adll_make(const char* const* texts, size_t count) {
+    return adll_from_array(texts, count);
+}
+
+static void bench_adll_append(void* list, const char* text) {
+    adll_append_node(list, adll_make_node(list, content_make(text)));
+}
+
+static adll_handle bench_adll_middle(adll_list* list) {
+    adll_handle cur = list->head;
+    for (size_t i = list->count / 2; i > 0; i--) {
+        cur = adll_next(list, cur);
+    }
+    return cur;
+}
+
+static void bench_adll_insert_middle(void* list, const char* text) {
+    adll_handle node = adll_make_node(list, content_make(text));
+    adll_insert_node(list, bench_adll_middle(list), node);
+}
+
+static bool bench_adll_search(void* list, const char* text, size_t length) {
+    _Alignas(my_content) char key[CONTENT_SIZE(BENCH_KEY_SIZE)];
+    return adll_search_node(list, content_init(key, text, length)) != ADLL_NIL;
+}
+
+static void bench_adll_remove_middle(void* list) {
+    adll_handle at = bench_adll_middle(list);
+    adll_remove_node(list, at);
+    adll_free_node(list, at);
+}
+
+static void bench_adll_remove_all(void* list) {
+    adll_remove_list(list);
+}
+
+static const bench_target bench_adll = {
+    "adll", bench_adll_make, bench_adll_append, bench_adll_insert_middle,
+    bench_adll_search, bench_adll_remove_middle, bench_adll_remove_all,
+};
+
+enum bench_op {
+    BENCH_MAKE,
+    BENCH_APPEND,
+    BENCH_INSERT_MIDDLE,
+    BENCH_SEARCH_HIT,
+    BENCH_SEARCH_MISS,
+    BENCH_REMOVE,
+    BENCH_REMOVE_ALL,
+    BENCH_OP_COUNT,
+};
+
+static const char* bench_op_names[BENCH_OP_COUNT] = {
+    "make", "append", "insert-middle", "search-hit", "search-miss", "remove", "remove-all",
+};
+
+typedef struct bench_result {
+    size_t ops;
+    double ns;
+    size_t allocs;
+} bench_result;
+
+/**
+ * @brief adding the time and the allocations since `start` /
+ * `allocs` to a result.
+ *
+ */
+static void bench_record(bench_result* result, size_t ops, double start, size_t allocs) {
+    result->ns += bench_now_ns() - start;
+    result->allocs += bench_alloc_count() - allocs;
+    result->ops += ops;
+}
+
+/**
+ * @brief running every operation on one target at one size. Whole
+ * list operations run over at least 2M elements in total and the
+ * per-element ones (walking to the middle or searching) over about
+ * 50M visited elements, so small sizes are repeated.
+ *
+ */
+static void bench_ops_case(const bench_target* target, size_t size, bench_result results[BENCH_OP_COUNT]) {
+    char* buf = malloc(size * BENCH_KEY_SIZE);
+    const char** texts = malloc(size * sizeof(char*));
+    for (size_t i = 0; i < size; i++) {
+        bench_key(buf + i * BENCH_KEY_SIZE, BENCH_KEY_SIZE, i);
+        texts[i] = buf + i * BENCH_KEY_SIZE;
+    }
+    // even keys are in the list. Odd keys are not, they read "kez-..."
+    // and have the length of a hit, so no length check shortcuts them.
+    char (*keys)[BENCH_KEY_SIZE] = malloc(2 * BENCH_KEYS * BENCH_KEY_SIZE);
+    size_t key_lengths[2 * BENCH_KEYS];
+    unsigned long long seed = 88172645463325252ULL;
+    for (size_t i = 0; i < 2 * BENCH_KEYS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        bench_key(keys[i], BENCH_KEY_SIZE, seed % size);
+        if (i % 2) {
+            keys[i][2] = 'z';
+        }
+        key_lengths[i] = strlen(keys[i]);
+    }
+    memset(results, 0, BENCH_OP_COUNT * sizeof(bench_result));
+
+    size_t rounds = 2000000 / size;
+    rounds = rounds < 1 ? 1 : rounds;
+    for (size_t round = 0; round < rounds; round++) {
+        double start = bench_now_ns();
+        size_t allocs = bench_alloc_count();
+        void* list = target->make(texts, size);
+        bench_record(&results[BENCH_MAKE], size, start, allocs);
+
+        start = bench_now_ns();
+        allocs = bench_alloc_count();
+        target->remove_all(list);
+        bench_record(&results[BENCH_REMOVE_ALL], size, start, allocs);
+
+        list = target->make(texts, 0);
+        start = bench_now_ns();
+        allocs = bench_alloc_count();
+        for (size_t i = 0; i < size; i++) {
+            target->append(list, texts[i]);
+        }
+        bench_record(&results[BENCH_APPEND], size, start, allocs);
+        target->remove_all(list);
+    }
+
+    void* list = target->make(texts, size);
+    size_t lookups = bench_scan_lookups(size);
+    double start = bench_now_ns();
+    size_t allocs = bench_alloc_count();
+    size_t found = 0;
+    for (size_t i = 0; i < lookups; i++) {
+        size_t key = 2 * (i % BENCH_KEYS);
+        found += target->search(list, keys[key], key_lengths[key]);
+    }
+    bench_record(&results[BENCH_SEARCH_HIT], lookups, start, allocs);
+
+    start = bench_now_ns();
+    allocs = bench_alloc_count();
+    for (size_t i = 0; i < lookups; i++) {
+        size_t key = 2 * (i % BENCH_KEYS) + 1;
+        found -= target->search(list, keys[key], key_lengths[key]);
+    }
+    bench_record(&results[BENCH_SEARCH_MISS], lookups, start, allocs);
+    assert(found == lookups);
+    bench_sink = found;
+
+    // inserting and removing in batches keeps the size between size and 2 * size.
+    size_t batch = lookups < size ? lookups : size;
+    for (size_t done = 0; done < lookups; done += batch) {
+        start = bench_now_ns();
+        allocs = bench_alloc_count();
+        for (size_t i = 0; i < batch; i++) {
+            target->insert_middle(list, texts[i]);
+        }
+        bench_record(&results[BENCH_INSERT_MIDDLE], batch, start, allocs);
+
+        start = bench_now_ns();
+        allocs = bench_alloc_count();
+        for (size_t i = 0; i < batch; i++) {
+            target->remove_middle(list);
+        }
+        bench_record(&results[BENCH_REMOVE], batch, start, allocs);
+    }
+
+    target->remove_all(list);
+    free(keys);
+    free(texts);
+    free(buf);
+}
+
+/**
+ * @brief running one case in a child process, so the peak RSS reported
+ * for it is its own and not the largest case run so far. The child
+ * prints its lines to stdout and to the result file. The peak includes
+ * the texts the lists are built from.
+ *
+ */
+static void bench_ops_fork(const bench_target* target, size_t size, FILE* output) {
+    fflush(stdout);
+    fflush(output);
+    pid_t pid = fork();
+    if (pid == 0) {
+        bench_result results[BENCH_OP_COUNT];
+        bench_ops_case(target, size, results);
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        for (int op = 0; op < BENCH_OP_COUNT; op++) {
+            bench_result* result = &results[op];
+            double ns = result->ns / result->ops;
+            double allocs = (double)result->allocs / result->ops;
+            printf("%-6s %10zu  %-13s %10zu ops %12.1f ns/op %8.2f allocs/op %9ld KB peak\n",
+                target->name, size, bench_op_names[op], result->ops, ns, allocs, usage.ru_maxrss);
+            fprintf(output, "%s\t%zu\t%s\t%zu\t%.1f\t%.3f\t%ld\n",
+                target->name, size, bench_op_names[op], result->ops, ns, allocs, usage.ru_maxrss);
+        }
+        if (list_trace_enabled()) {
+            list_trace_dump(stdout);
+        }
+        fflush(stdout);
+        fflush(output);
+        _exit(0);
+    }
+
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("%-6s %10zu  failed\n", target->name, size);
+    }
+}
+
+/**
+ * @brief making a doubly linked-list of text nodes one by one, with
+ * malloc'ed nodes against an arena list (dll_make_arena_list), and
+ * tearing it down with dll_remove_list. Building and tearing down are
+ * timed apart.
+ *
+ */
+void bench_teardown(size_t max_size) {
+    printf("*** tearing down: malloc'ed nodes vs. arena list\n");
+    for (size_t size = 1000; size <= max_size; size *= 10) {
+        char* buf = malloc(size * 32);
+        for (size_t i = 0; i < size; i++) {
+            bench_key(buf + i * 32, 32, i);
+        }
+
+        for (int arena = 0; arena < 2; arena++) {
+            const char* method = arena ? "arena" : "malloc";
+            double start = bench_now_ns();
+            my_dll_list* dll = arena ? dll_make_arena_list(0) : dll_from_array(NULL, 0);
+            for (size_t i = 0; i < size; i++) {
+                dll_append_node(dll, dll_make_text_node(dll, buf + i * 32));
+            }
+            double built = bench_now_ns();
+            dll_remove_list(dll);
+            double done = bench_now_ns();
+            printf("dll  %10zu  %-8s %8.2f ns/node build %10.2f ns/node teardown\n",
+                size, method, (built - start) / size, (done - built) / size);
+            fflush(stdout);
+        }
+        free(buf);
+    }
+}
+
+static void bench_print_report(const char* list, size_t size, const char* method, double ns) {
+    printf("%-4s %10zu  %-8s %8.2f ns/node %8.1f M nodes/s\n", list, size, method, ns / size, size * 1e3 / ns);
+    fflush(stdout);
+}
+
+/**
+ * @brief dumping a list to /dev/null with one fprintf per node (the way
+ * the print functions used to) against the buffered writer of
+ * list_writer.h, to a FILE* and to a file descriptor.
+ *
+ */
+void bench_print(size_t max_size) {
+    printf("*** printing: fprintf per node vs. list_writer\n");
+    FILE* null_file = fopen("/dev/null", "w");
+    if (null_file == NULL) {
+        perror("/dev/null");
+        return;
+    }
+    for (size_t size = 1000; size <= max_size; size *= 10) {
+        char* buf = malloc(size * 32);
+        const char** texts = malloc(size * sizeof(char*));
+        for (size_t i = 0; i < size; i++) {
+            bench_key(buf + i * 32, 32, i);
+            texts[i] = buf + i * 32;
+        }
+        my_sll_list* sll = sll_from_array(texts, size);
+        my_dll_list* dll = dll_from_array(texts, size);
+        size_t passes = 10000000 / size;
+        passes = passes < 1 ? 1 : passes;
+
+        double start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            size_t node_no = 1;
+            for (my_dll* cur = dll->head; cur != NULL; cur = cur->next_ptr) {
+                fprintf(null_file, "%zu. %s\n", node_no++, cur->content->text);
+            }
+            fprintf(null_file, ">>> list size: %zu\n", dll->count);
+        }
+        fflush(null_file);
+        bench_print_report("dll", size, "fprintf", (bench_now_ns() - start) / passes);
+
+        list_writer writer;
+        start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            list_writer_init_file(&writer, null_file, LIST_COLOR_AUTO);
+            dll_write_list(dll, &writer);
+            list_writer_release(&writer);
+        }
+        fflush(null_file);
+        bench_print_report("dll", size, "FILE*", (bench_now_ns() - start) / passes);
+
+        start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            list_writer_init_fd(&writer, fileno(null_file), LIST_COLOR_AUTO);
+            dll_write_list(dll, &writer);
+            list_writer_release(&writer);
+        }
+        bench_print_report("dll", size, "fd", (bench_now_ns() - start) / passes);
+
+        start = bench_now_ns();
+        for (size_t pass = 0; pass < passes; pass++) {
+            list_writer_init_fd(&writer, fileno(null_file), LIST_COLOR_AUTO);
+            sll_write(sll, &writer);
+            list_writer_release(&writer);
+        }
+        bench_print_report("sll", size, "fd", (bench_now_ns() - start) / passes);
+
+        sll_remove_all(sll);
+        dll_remove_list(dll);
+        free(texts);
+        free(buf);
+    }
+    fclose(null_file);
+}
+
+/**
+ * @brief make, append, insert-middle, search-hit, search-miss, remove
+ * and remove-all for every target at sizes 10 to max-size.
+ *
+ */
+void bench_ops(size_t max_size) {
+    const bench_target* targets[] = {
+        &bench_sll,
+        &bench_dll,
+        &bench_adll,
+#ifdef BENCH_STD
+        &bench_std_vector,
+        &bench_std_list,
+        &bench_cpp_list,
+        &bench_cpp_dlist,
+#endif
+    };
+    size_t target_count = sizeof(targets) / sizeof(targets[0]);
+
+    FILE* output = fopen(BENCH_OUTPUT, "w");
+    if (output == NULL) {
+        perror(BENCH_OUTPUT);
+        return;
+    }
+    fprintf(output, "# target\tsize\top\tops\tns_per_op\tallocs_per_op\tpeak_rss_kb\n");
+
+    printf("*** operations: sll, dll");
+#ifdef BENCH_STD
+    printf(", std::vector<std::string>, std::list<std::string>, List<bench_text>, DList<bench_text>");
+#endif
+    printf("\n");
+    for (size_t size = 10; size <= max_size; size *= 10) {
+        for (size_t i = 0; i < target_count; i++) {
+            bench_ops_fork(targets[i], size, output);
+        }
+    }
+    fclose(output);
+    printf("results written to %s\n", BENCH_OUTPUT);
+}
+
+#define BENCH_LF_KEYS 1024
+#define BENCH_LF_OPS 400000
+
+typedef struct bench_lf_worker {
+    lf_sll_list* lf;
+    my_sll_list* sll;
+    pthread_mutex_t* lock;
+    my_content** keys;
+    int search_percent;
+    unsigned long long seed;
+} bench_lf_worker;
+
+/**
+ * @brief one thread's share of the work: searches for search_percent
+ * of the operations, the rest split between inserts and removes, on
+ * random keys.
+ *
+ */
+static void* bench_lf_run(void* arg) {
+    bench_lf_worker* worker = arg;
+    hp_thread* thread = worker->lf != NULL ? lf_sll_enter(worker->lf) : NULL;
+    unsigned long long seed = worker->seed;
+    for (int i = 0; i < BENCH_LF_OPS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        my_content* key = worker->keys[seed % BENCH_LF_KEYS];
+        int op = (seed >> 32) % 100;
+        if (worker->lf != NULL) {
+            if (op < worker->search_percent) {
+                lf_sll_contains(worker->lf, thread, key);
+            } else if (op % 2) {
+                lf_sll_insert(worker->lf, thread, key->text);
+            } else {
+                lf_sll_remove(worker->lf, thread, key);
+            }
+            continue;
+        }
+
+        pthread_mutex_lock(worker->lock);
+        my_sll* at = sll_search(worker->sll, key);
+        if (op < worker->search_percent) {
+            // the search is all there is to do.
+        } else if (op % 2) {
+            if (at == NULL) {
+                sll_append_node(worker->sll, sll_make_text_node(worker->sll, key->text));
+            }
+        } else if (at != NULL) {
+            sll_remove_node(worker->sll, at);
+            sll_free_node(worker->sll, at);
+        }
+        pthread_mutex_unlock(worker->lock);
+    }
+    if (thread != NULL) {
+        lf_sll_leave(worker->lf, thread);
+    }
+    return NULL;
+}
+
+/**
+ * @brief throughput of the lock-free list against my_sll behind one
+ * mutex, for 1 to max_threads threads and two mixes of operations.
+ * Both start with every other key.
+ *
+ */
+void bench_lockfree(size_t max_threads) {
+    printf("*** concurrency: lock-free sorted list vs. my_sll behind a mutex, %d keys\n", BENCH_LF_KEYS);
+    if (max_threads > HP_MAX_THREADS) {
+        max_threads = HP_MAX_THREADS;
+    }
+    my_content* keys[BENCH_LF_KEYS];
+    char buf[32];
+    for (size_t i = 0; i < BENCH_LF_KEYS; i++) {
+        bench_key(buf, sizeof(buf), i);
+        keys[i] = content_make(buf);
+    }
+
+    int mixes[] = { 90, 50 };
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            for (int locked = 0; locked < 2; locked++) {
+                lf_sll_list* lf = NULL;
+                my_sll_list* sll = NULL;
+                pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+                if (locked) {
+                    sll = sll_from_array(NULL, 0);
+                } else {
+                    lf = lf_sll_make();
+                }
+                hp_thread* thread = lf != NULL ? lf_sll_enter(lf) : NULL;
+                for (size_t i = 0; i < BENCH_LF_KEYS; i += 2) {
+                    if (lf != NULL) {
+                        lf_sll_insert(lf, thread, keys[i]->text);
+                    } else {
+                        sll_append_node(sll, sll_make_text_node(sll, keys[i]->text));
+                    }
+                }
+                if (thread != NULL) {
+                    lf_sll_leave(lf, thread);
+                }
+
+                pthread_t ids[HP_MAX_THREADS];
+                bench_lf_worker workers[HP_MAX_THREADS];
+                double start = bench_now_ns();
+                for (size_t t = 0; t < threads; t++) {
+                    workers[t] = (bench_lf_worker){ lf, sll, &lock, keys, mixes[m], 88172645463325252ULL + t * 7919 };
+                    pthread_create(&ids[t], NULL, bench_lf_run, &workers[t]);
+                }
+                for (size_t t = 0; t < threads; t++) {
+                    pthread_join(ids[t], NULL);
+                }
+                double ns = bench_now_ns() - start;
+
+                printf("%-8s %2zu threads  %d%% search  %8.2f Mops/s\n", locked ? "mutex" : "lockfree",
+                    threads, mixes[m], threads * BENCH_LF_OPS / ns * 1e3);
+                fflush(stdout);
+                if (locked) {
+                    sll_remove_all(sll);
+                } else {
+                    lf_sll_free(lf);
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < BENCH_LF_KEYS; i++) {
+        content_free(keys[i]);
+    }
+}
+
+#define BENCH_CDLL_MAX_THREADS 64
+
+typedef struct bench_cdll_worker {
+    cdll_list* cdll;
+    my_dll_list* dll;
+    pthread_rwlock_t* lock;
+    my_content** keys;
+    int search_percent;
+    unsigned long long seed;
+} bench_cdll_worker;
+
+/**
+ * @brief one thread's share of the work, the same mix as bench_lf_run.
+ *
+ */
+static void* bench_cdll_run(void* arg) {
+    bench_cdll_worker* worker = arg;
+    unsigned long long seed = worker->seed;
+    for (int i = 0; i < BENCH_LF_OPS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        my_content* key = worker->keys[seed % BENCH_LF_KEYS];
+        int op = (seed >> 32) % 100;
+        if (worker->cdll != NULL) {
+            if (op < worker->search_percent) {
+                cdll_contains(worker->cdll, key);
+            } else if (op % 2) {
+                cdll_insert(worker->cdll, key->text);
+            } else {
+                cdll_remove(worker->cdll, key);
+            }
+            continue;
+        }
+
+        if (op < worker->search_percent) {
+            pthread_rwlock_rdlock(worker->lock);
+            dll_search_node(worker->dll, key);
+            pthread_rwlock_unlock(worker->lock);
+            continue;
+        }
+        pthread_rwlock_wrlock(worker->lock);
+        my_dll* at = dll_search_node(worker->dll, key);
+        if (op % 2) {
+            if (at == NULL) {
+                dll_append_node(worker->dll, dll_make_text_node(worker->dll, key->text));
+            }
+        } else if (at != NULL) {
+            dll_remove_node(worker->dll, at);
+            dll_free_node(worker->dll, at);
+        }
+        pthread_rwlock_unlock(worker->lock);
+    }
+    return NULL;
+}
+
+/**
+ * @brief throughput of the hand-over-hand locked list against my_dll
+ * behind one reader-writer lock, for 1 to max_threads threads and a
+ * 90/10 and a 50/50 mix of searches and changes. Both start with every
+ * other key.
+ *
+ */
+void bench_concurrent(size_t max_threads) {
+    printf("*** concurrency: per-node locked dll vs. my_dll behind a rwlock, %d keys\n", BENCH_LF_KEYS);
+    if (max_threads > BENCH_CDLL_MAX_THREADS) {
+        max_threads = BENCH_CDLL_MAX_THREADS;
+    }
+    my_content* keys[BENCH_LF_KEYS];
+    char buf[32];
+    for (size_t i = 0; i < BENCH_LF_KEYS; i++) {
+        bench_key(buf, sizeof(buf), i);
+        keys[i] = content_make(buf);
+    }
+
+    int mixes[] = { 90, 50 };
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            for (int locked = 0; locked < 2; locked++) {
+                cdll_list* cdll = NULL;
+                my_dll_list* dll = NULL;
+                pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+                if (locked) {
+                    dll = dll_from_array(NULL, 0);
+                } else {
+                    cdll = cdll_make_list();
+                }
+                for (size_t i = 0; i < BENCH_LF_KEYS; i += 2) {
+                    if (cdll != NULL) {
+                        cdll_insert(cdll, keys[i]->text);
+                    } else {
+                        dll_append_node(dll, dll_make_text_node(dll, keys[i]->text));
+                    }
+                }
+
+                pthread_t ids[BENCH_CDLL_MAX_THREADS];
+                bench_cdll_worker workers[BENCH_CDLL_MAX_THREADS];
+                double start = bench_now_ns();
+                for (size_t t = 0; t < threads; t++) {
+                    workers[t] = (bench_cdll_worker){ cdll, dll, &lock, keys, mixes[m], 88172645463325252ULL + t * 7919 };
+                    pthread_create(&ids[t], NULL, bench_cdll_run, &workers[t]);
+                }
+                for (size_t t = 0; t < threads; t++) {
+                    pthread_join(ids[t], NULL);
+                }
+                double ns = bench_now_ns() - start;
+
+                printf("%-8s %2zu threads  %d%% search  %8.2f Mops/s\n", locked ? "rwlock" : "per-node",
+                    threads, mixes[m], threads * BENCH_LF_OPS / ns * 1e3);
+                fflush(stdout);
+                if (locked) {
+                    dll_remove_list(dll);
+                } else {
+                    cdll_remove_list(cdll);
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < BENCH_LF_KEYS; i++) {
+        content_free(keys[i]);
+    }
+}
+
+#define BENCH_SNAPSHOT_WALKS 2000
+
+typedef struct bench_snapshot_worker {
+    psll_list* psll;
+    my_sll_list* sll;
+    pthread_rwlock_t* lock;
+    atomic_bool* done;
+    size_t visits;
+} bench_snapshot_worker;
+
+/**
+ * @brief a reader: walks the whole list BENCH_SNAPSHOT_WALKS times,
+ * from a snapshot or under the read lock.
+ *
+ */
+static void* bench_snapshot_read(void* arg) {
+    bench_snapshot_worker* worker = arg;
+    hp_thread* thread = worker->psll != NULL ? psll_enter(worker->psll) : NULL;
+    for (int i = 0; i < BENCH_SNAPSHOT_WALKS; i++) {
+        if (worker->psll != NULL) {
+            const psll_version* version = psll_snapshot(worker->psll, thread);
+            for (const psll_node* cur = version->head; cur != NULL; cur = cur->next_ptr) {
+                worker->visits += cur->content->length > 0;
+            }
+            psll_release(thread);
+            continue;
+        }
+        pthread_rwlock_rdlock(worker->lock);
+        for (my_sll* cur = worker->sll->head; cur != NULL; cur = cur->next_ptr) {
+            worker->visits += cur->content->length > 0;
+        }
+        pthread_rwlock_unlock(worker->lock);
+    }
+    if (thread != NULL) {
+        psll_leave(worker->psll, thread);
+    }
+    return NULL;
+}
+
+/**
+ * @brief the writer: prepends a node and removes the first one again,
+ * until the readers are done. visits counts its changes.
+ *
+ */
+static void* bench_snapshot_write(void* arg) {
+    bench_snapshot_worker* worker = arg;
+    hp_thread* thread = worker->psll != NULL ? psll_enter(worker->psll) : NULL;
+    while (!atomic_load_explicit(worker->done, memory_order_relaxed)) {
+        if (worker->psll != NULL) {
+            psll_prepend(worker->psll, thread, "*** new ***");
+            psll_remove(worker->psll, thread, psll_current(worker->psll)->head);
+        } else {
+            pthread_rwlock_wrlock(worker->lock);
+            sll_prepend_node(worker->sll, sll_make_text_node(worker->sll, "*** new ***"));
+            my_sll* head = worker->sll->head;
+            sll_remove_node(worker->sll, head);
+            sll_free_node(worker->sll, head);
+            pthread_rwlock_unlock(worker->lock);
+        }
+        worker->visits += 2;
+    }
+    if (thread != NULL) {
+        psll_leave(worker->psll, thread);
+    }
+    return NULL;
+}
+
+/**
+ * @brief readers walking a list of BENCH_LF_KEYS nodes while one writer
+ * changes it: snapshots of the persistent list against my_sll behind
+ * a rwlock, for 1 to max_threads readers.
+ *
+ */
+void bench_snapshot(size_t max_threads) {
+    printf("*** concurrency: persistent list snapshots vs. my_sll behind a rwlock, %d nodes, 1 writer\n",
+        BENCH_LF_KEYS);
+    if (max_threads > HP_MAX_THREADS - 1) {
+        max_threads = HP_MAX_THREADS - 1;
+    }
+    char buf[32];
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        for (int locked = 0; locked < 2; locked++) {
+            psll_list* psll = NULL;
+            my_sll_list* sll = NULL;
+            pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+            atomic_bool done = false;
+            if (locked) {
+                sll = sll_from_array(NULL, 0);
+            } else {
+                psll = psll_make();
+            }
+            hp_thread* thread = psll != NULL ? psll_enter(psll) : NULL;
+            for (size_t i = 0; i < BENCH_LF_KEYS; i++) {
+                bench_key(buf, sizeof(buf), i);
+                if (psll != NULL) {
+                    psll_prepend(psll, thread, buf);
+                } else {
+                    sll_prepend_node(sll, sll_make_text_node(sll, buf));
+                }
+            }
+            if (thread != NULL) {
+                psll_leave(psll, thread);
+            }
+
+            pthread_t writer_id;
+            pthread_t ids[HP_MAX_THREADS];
+            bench_snapshot_worker writer = { psll, sll, &lock, &done, 0 };
+            bench_snapshot_worker workers[HP_MAX_THREADS];
+            double start = bench_now_ns();
+            pthread_create(&writer_id, NULL, bench_snapshot_write, &writer);
+            for (size_t t = 0; t < threads; t++) {
+                workers[t] = (bench_snapshot_worker){ psll, sll, &lock, &done, 0 };
+                pthread_create(&ids[t], NULL, bench_snapshot_read, &workers[t]);
+            }
+            size_t visits = 0;
+            for (size_t t = 0; t < threads; t++) {
+                pthread_join(ids[t], NULL);
+                visits += workers[t].visits;
+            }
+            double ns = bench_now_ns() - start;
+            atomic_store(&done, true);
+            pthread_join(writer_id, NULL);
+
+            printf("%-10s %2zu readers  %8.2f M nodes read/s  %8.2f M writes/s\n", locked ? "rwlock" : "snapshot",
+                threads, visits / ns * 1e3, writer.visits / ns * 1e3);
+            fflush(stdout);
+            if (locked) {
+                sll_remove_all(sll);
+            } else {
+                psll_free(psll);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* suite = argc > 1 ? argv[1] : "index";
+    size_t max_size = argc > 2 ? strtoull(argv[2], NULL, 10) : BENCH_MAX_SIZE;
+
+    if (strcmp(suite, "index") == 0) {
+        bench_index(max_size);
+    } else if (strcmp(suite, "unrolled") == 0) {
+        bench_unrolled(max_size);
+    } else if (strcmp(suite, "build") == 0) {
+        bench_build(max_size);
+    } else if (strcmp(suite, "print") == 0) {
+        bench_print(max_size);
+    } else if (strcmp(suite, "teardown") == 0) {
+        bench_teardown(max_size);
+    } else if (strcmp(suite, "ops") == 0) {
+        bench_ops(max_size);
+    } else if (strcmp(suite, "lockfree") == 0) {
+        bench_lockfree(argc > 2 ? max_size : 8);
+    } else if (strcmp(suite, "concurrent") == 0) {
+        bench_concurrent(argc > 2 ? max_size : 8);
+    } else if (strcmp(suite, "snapshot") == 0) {
+        bench_snapshot(argc > 2 ? max_size : 8);
+    } else {
+        printf("unknown suite: %s\n", suite);
+        return 1;
+    }
+    return 0;
+}
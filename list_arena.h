@@ -0,0 +1,184 @@
+#ifndef LIST_ARENA_H
+#define LIST_ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "list_pool.h"
+
+/**
+ * @brief A bump allocator for building many nodes at once.
+ * Memory is handed out in order from a few large blocks and is never
+ * given back one piece at a time: everything goes away together with
+ * list_arena_free, or is handed out again after list_arena_reset.
+ * Nodes and their texts sit next to each other, in the order they were
+ * made.
+ *
+ * Pieces can have any size, unlike the nodes of a list_pool. Every new
+ * block is twice as large as the one before (up to
+ * LIST_ARENA_MAX_BLOCK_SIZE), so an arena that keeps growing has few
+ * blocks for list_arena_owns to walk.
+ *
+ */
+typedef struct list_arena_block {
+    struct list_arena_block* next_ptr;
+    char* end;
+} list_arena_block;
+
+typedef struct list_arena {
+    size_t block_size;
+    list_arena_block* blocks;   // the newest block first
+    char* next_free;            // untouched space of the newest block
+    char* block_end;
+} list_arena;
+
+#define LIST_ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+#define LIST_ARENA_MAX_BLOCK_SIZE (64 * 1024 * 1024)
+
+/**
+ * @brief making an arena. The first block is allocated by the first
+ * list_arena_alloc.
+ *
+ * @cond block_size 0 means the default. Larger sizes are capped at
+ * LIST_ARENA_MAX_BLOCK_SIZE.
+ *
+ * @param block_size
+ * @return list_arena*
+ */
+static inline list_arena* list_arena_make(size_t block_size) {
+    if (block_size == 0) {
+        block_size = LIST_ARENA_DEFAULT_BLOCK_SIZE;
+    } else if (block_size > LIST_ARENA_MAX_BLOCK_SIZE) {
+        block_size = LIST_ARENA_MAX_BLOCK_SIZE;
+    }
+
+    list_arena* arena = malloc(sizeof(list_arena));
+    arena->block_size = block_size;
+    arena->blocks = NULL;
+    arena->next_free = NULL;
+    arena->block_end = NULL;
+    return arena;
+}
+
+/**
+ * @brief handing out `size` bytes, aligned for any type. A piece
+ * larger than the block size gets a block of its own.
+ *
+ * @param arena
+ * @param size
+ * @return void* NULL when out of memory.
+ */
+static inline void* list_arena_alloc(list_arena* arena, size_t size) {
+    size = list_pool_align(size);
+    if ((size_t)(arena->block_end - arena->next_free) < size) {
+        size_t header = list_pool_align(sizeof(list_arena_block));
+        size_t space = size > arena->block_size ? size : arena->block_size;
+        list_arena_block* block = malloc(header + space);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next_ptr = arena->blocks;
+        block->end = (char*)block + header + space;
+        arena->blocks = block;
+        arena->next_free = (char*)block + header;
+        arena->block_end = block->end;
+        if (arena->block_size < LIST_ARENA_MAX_BLOCK_SIZE / 2) {
+            arena->block_size *= 2;
+        }
+    }
+
+    void* memory = arena->next_free;
+    arena->next_free += size;
+    return memory;
+}
+
+/**
+ * @brief true when the memory was handed out by this arena, so it must
+ * not be freed on its own.
+ *
+ * @param arena may be NULL.
+ * @param memory
+ * @return true
+ * @return false
+ */
+static inline bool list_arena_owns(const list_arena* arena, const void* memory) {
+    if (arena == NULL) {
+        return false;
+    }
+    for (list_arena_block* block = arena->blocks; block != NULL; block = block->next_ptr) {
+        if ((const char*)memory > (const char*)block && (const char*)memory < block->end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief moving every block of `from` into `into`, for when the nodes
+ * of one list move to another. `into` keeps handing out memory from
+ * its newest block. return the arena that holds them all.
+ *
+ * @param into may be NULL.
+ * @param from may be NULL; it is freed.
+ * @return list_arena*
+ */
+static inline list_arena* list_arena_merge(list_arena* into, list_arena* from) {
+    if (into == NULL) {
+        return from;
+    }
+    if (from == NULL) {
+        return into;
+    }
+    list_arena_block** link = &into->blocks;
+    while (*link != NULL) {
+        link = &(*link)->next_ptr;
+    }
+    *link = from->blocks;
+    free(from);
+    return into;
+}
+
+/**
+ * @brief making all memory of the arena free again. The newest (and
+ * largest) block is kept for the memory handed out next, the others
+ * are freed. All memory handed out by the arena becomes invalid.
+ *
+ * @param arena may be NULL.
+ */
+static inline void list_arena_reset(list_arena* arena) {
+    if (arena == NULL || arena->blocks == NULL) {
+        return;
+    }
+    list_arena_block* block = arena->blocks->next_ptr;
+    while (block != NULL) {
+        list_arena_block* next = block->next_ptr;
+        free(block);
+        block = next;
+    }
+    arena->blocks->next_ptr = NULL;
+    arena->next_free = (char*)arena->blocks + list_pool_align(sizeof(list_arena_block));
+    arena->block_end = arena->blocks->end;
+}
+
+/**
+ * @brief freeing every block of the arena. All memory handed out by
+ * the arena becomes invalid. return NULL when complete.
+ *
+ * @param arena
+ * @return list_arena*
+ */
+static inline list_arena* list_arena_free(list_arena* arena) {
+    if (arena == NULL) {
+        return NULL;
+    }
+    list_arena_block* block = arena->blocks;
+    while (block != NULL) {
+        list_arena_block* next = block->next_ptr;
+        free(block);
+        block = next;
+    }
+    free(arena);
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef LIST_BENCH_H
+#define LIST_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One list implementation under benchmark, seen through the
+ * operations the "ops" suite of list-bench measures. The C lists are
+ * wrapped in list-bench.c, the C++ baselines in list-bench-std.cpp.
+ *
+ * The middle is the node at position size / 2, found the way the
+ * implementation allows (walking for the linked lists).
+ *
+ */
+typedef struct bench_target {
+    const char* name;
+    void* (*make)(const char* const* texts, size_t count);
+    void (*append)(void* list, const char* text);
+    void (*insert_middle)(void* list, const char* text);
+    bool (*search)(void* list, const char* text, size_t length);
+    void (*remove_middle)(void* list);
+    void (*remove_all)(void* list);
+} bench_target;
+
+/**
+ * @brief std::vector<std::string> and std::list<std::string>, built
+ * into list-bench when it is compiled with -DBENCH_STD.
+ *
+ */
+extern const bench_target bench_std_vector;
+extern const bench_target bench_std_list;
+
+/**
+ * @brief List<T> and DList<T> of my_list.hpp, holding a text with its
+ * hash like my_content, also from list-bench-std.cpp.
+ *
+ */
+extern const bench_target bench_cpp_list;
+extern const bench_target bench_cpp_dlist;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
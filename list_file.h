@@ -0,0 +1,330 @@
+#ifndef LIST_FILE_H
+#define LIST_FILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "list_log.h"
+#include "my_content.h"
+
+/**
+ * @brief A binary file of list contents that can be used in place.
+ *
+ *   header   list_file_header, 32 bytes
+ *   records  one per content, laid out exactly like a my_content: the
+ *            length (8 bytes), the hash of the text (8 bytes), the text
+ *            and its '\0', padded to 8 bytes
+ *   table    the file offset of every record, 8 bytes each, in order
+ *
+ * Because a record is a my_content, a mapped file hands out contents
+ * that point straight into the mapping: loading copies no text. It
+ * still reads every record, since list_file_content checks its bounds,
+ * its '\0' and its hash, so a load costs O(file size) and faults in the
+ * whole record area. The file is written and read in the byte order of
+ * the machine; a file from another byte order is refused.
+ *
+ * A list_file_writer writes the records as they come and the table and
+ * the header at the end. It writes to a temporary file next to the
+ * target and renames it over the target when done, so a list that was
+ * loaded from a file can be saved back to it while the old file is
+ * still mapped. list_file_map maps a file read-only.
+ *
+ */
+#define LIST_FILE_MAGIC "LISTFILE"
+#define LIST_FILE_VERSION 2
+#define LIST_FILE_BYTE_ORDER 0x01020304u
+#define LIST_FILE_ALIGN 8
+
+typedef struct list_file_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t count;
+    uint64_t table_offset;
+} list_file_header;
+
+_Static_assert(sizeof(list_file_header) == 32, "list_file_header is 32 bytes");
+_Static_assert(sizeof(size_t) == 8 && offsetof(my_content, hash) == 8 && offsetof(my_content, text) == 16,
+    "records are laid out as my_content with an 8 byte length and hash");
+
+typedef struct list_file_writer {
+    FILE* file;
+    char* path;
+    char* temp_path;
+    uint64_t position;
+    uint64_t* offsets;
+    size_t count;
+    size_t capacity;
+    bool failed;
+} list_file_writer;
+
+/**
+ * @brief starting a list file. The file at `path` is replaced only when
+ * the writer is closed without errors.
+ *
+ * @param path
+ * @return list_file_writer* NULL when the file cannot be created.
+ */
+static inline list_file_writer* list_file_writer_open(const char* path) {
+    size_t length = strlen(path);
+    char* temp_path = malloc(length + sizeof(".XXXXXX"));
+    memcpy(temp_path, path, length);
+    memcpy(temp_path + length, ".XXXXXX", sizeof(".XXXXXX"));
+    int fd = mkstemp(temp_path);
+    FILE* file = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    if (file == NULL) {
+        LOG_ERROR("cannot create %s!\n", path);
+        if (fd >= 0) {
+            close(fd);
+            unlink(temp_path);
+        }
+        free(temp_path);
+        return NULL;
+    }
+    list_file_writer* writer = malloc(sizeof(list_file_writer));
+    writer->file = file;
+    writer->path = strdup(path);
+    writer->temp_path = temp_path;
+    writer->position = sizeof(list_file_header);
+    writer->offsets = NULL;
+    writer->count = 0;
+    writer->capacity = 0;
+    writer->failed = false;
+
+    // the header is written for real once the table is known.
+    list_file_header header = { 0 };
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        writer->failed = true;
+    }
+    return writer;
+}
+
+/**
+ * @brief appending a content as the next record.
+ *
+ * @param writer
+ * @param content
+ * @return list_status
+ */
+static inline list_status list_file_write(list_file_writer* writer, const my_content* content) {
+    if (writer == NULL || content == NULL) {
+        LOG_ERROR("writer and/or content is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (writer->count == writer->capacity) {
+        size_t capacity = writer->capacity > 0 ? writer->capacity * 2 : 1024;
+        uint64_t* offsets = realloc(writer->offsets, capacity * sizeof(uint64_t));
+        if (offsets == NULL) {
+            return LIST_ERR_NO_MEMORY;
+        }
+        writer->offsets = offsets;
+        writer->capacity = capacity;
+    }
+
+    static const char padding[LIST_FILE_ALIGN] = { 0 };
+    size_t size = CONTENT_SIZE(content->length);
+    size_t padded = (size + LIST_FILE_ALIGN - 1) & ~(size_t)(LIST_FILE_ALIGN - 1);
+    if (fwrite(content, 1, size, writer->file) != size ||
+            fwrite(padding, 1, padded - size, writer->file) != padded - size) {
+        writer->failed = true;
+        return LIST_ERR_IO;
+    }
+    writer->offsets[writer->count++] = writer->position;
+    writer->position += padded;
+    return LIST_OK;
+}
+
+/**
+ * @brief writing the table and the header, closing the file, putting
+ * it in place of the target and freeing the writer. After an error the
+ * target is left as it was.
+ *
+ * @param writer
+ * @return list_status LIST_ERR_IO when any write failed.
+ */
+static inline list_status list_file_writer_close(list_file_writer* writer) {
+    if (writer == NULL) {
+        LOG_ERROR("writer is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    list_file_header header;
+    memcpy(header.magic, LIST_FILE_MAGIC, sizeof(header.magic));
+    header.version = LIST_FILE_VERSION;
+    header.byte_order = LIST_FILE_BYTE_ORDER;
+    header.count = writer->count;
+    header.table_offset = writer->position;
+
+    // an empty list has no table (and offsets is still NULL).
+    bool failed = writer->failed ||
+        (writer->count > 0 &&
+            fwrite(writer->offsets, sizeof(uint64_t), writer->count, writer->file) != writer->count) ||
+        fseek(writer->file, 0, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, writer->file) != 1;
+    failed = fclose(writer->file) != 0 || failed;
+    if (failed || rename(writer->temp_path, writer->path) != 0) {
+        unlink(writer->temp_path);
+        failed = true;
+    }
+    free(writer->offsets);
+    free(writer->temp_path);
+    free(writer->path);
+    free(writer);
+    if (failed) {
+        LOG_ERROR("writing the list file failed!\n");
+        return LIST_ERR_IO;
+    }
+    return LIST_OK;
+}
+
+/**
+ * @brief A list file mapped read-only. A list can hold contents from
+ * several files; they are chained through next_ptr.
+ *
+ */
+typedef struct list_file {
+    struct list_file* next_ptr;
+    const char* base;
+    size_t size;
+    uint64_t count;
+    const uint64_t* offsets;
+} list_file;
+
+/**
+ * @brief mapping a list file and checking its header and table.
+ *
+ * @param path
+ * @return list_file* NULL when the file cannot be mapped or is not a
+ * list file.
+ */
+static inline list_file* list_file_map(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("cannot open %s!\n", path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(list_file_header)) {
+        LOG_ERROR("%s is not a list file!\n", path);
+        close(fd);
+        return NULL;
+    }
+    size_t size = st.st_size;
+    void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR("cannot map %s!\n", path);
+        return NULL;
+    }
+
+    const list_file_header* header = base;
+    if (memcmp(header->magic, LIST_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != LIST_FILE_VERSION || header->byte_order != LIST_FILE_BYTE_ORDER ||
+            header->table_offset < sizeof(list_file_header) || header->table_offset % LIST_FILE_ALIGN != 0 ||
+            header->table_offset > size || header->count > (size - header->table_offset) / sizeof(uint64_t)) {
+        LOG_ERROR("%s is not a list file!\n", path);
+        munmap(base, size);
+        return NULL;
+    }
+
+    list_file* file = malloc(sizeof(list_file));
+    file->next_ptr = NULL;
+    file->base = base;
+    file->size = size;
+    file->count = header->count;
+    file->offsets = (const uint64_t*)(file->base + header->table_offset);
+    return file;
+}
+
+/**
+ * @brief the content of record i, in the mapping. It is read-only.
+ * The stored hash is recomputed from the text: content_equals and the
+ * hash index trust it, so a damaged hash would make them miss.
+ *
+ * @param file
+ * @param i
+ * @return const my_content* NULL when the record is out of bounds or
+ * its hash does not match its text.
+ */
+static inline const my_content* list_file_content(const list_file* file, uint64_t i) {
+    if (i >= file->count) {
+        return NULL;
+    }
+    uint64_t offset = file->offsets[i];
+    uint64_t records_end = (const char*)file->offsets - file->base;
+    // no sums of offsets from the file: a damaged offset could wrap.
+    if (offset < sizeof(list_file_header) || offset % LIST_FILE_ALIGN != 0 || offset >= records_end ||
+            records_end - offset <= offsetof(my_content, text)) {
+        return NULL;
+    }
+    const my_content* content = (const my_content*)(file->base + offset);
+    if (content->length >= records_end - offset - offsetof(my_content, text) ||
+            content->text[content->length] != '\0' ||
+            content->hash != content_hash(content->text, content->length)) {
+        return NULL;
+    }
+    return content;
+}
+
+/**
+ * @brief true when the memory is inside one of the mapped files, so it
+ * must not be freed.
+ *
+ * @param file may be NULL.
+ * @param memory
+ * @return true
+ * @return false
+ */
+static inline bool list_file_owns(const list_file* file, const void* memory) {
+    for (; file != NULL; file = file->next_ptr) {
+        if ((const char*)memory >= file->base && (const char*)memory < file->base + file->size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief chaining the files of `from` behind those of `into`, for when
+ * the nodes of one list move to another. return the chain.
+ *
+ * @param into may be NULL.
+ * @param from may be NULL.
+ * @return list_file*
+ */
+static inline list_file* list_file_merge(list_file* into, list_file* from) {
+    if (into == NULL) {
+        return from;
+    }
+    list_file* last = into;
+    while (last->next_ptr != NULL) {
+        last = last->next_ptr;
+    }
+    last->next_ptr = from;
+    return into;
+}
+
+/**
+ * @brief unmapping the file and every file chained to it. All contents
+ * handed out become invalid. return NULL when complete.
+ *
+ * @param file
+ * @return list_file*
+ */
+static inline list_file* list_file_unmap(list_file* file) {
+    while (file != NULL) {
+        list_file* next = file->next_ptr;
+        munmap((void*)file->base, file->size);
+        free(file);
+        file = next;
+    }
+    return NULL;
+}
+
+#endif
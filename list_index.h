@@ -0,0 +1,206 @@
+#ifndef LIST_INDEX_H
+#define LIST_INDEX_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "list_pool.h"
+#include "my_content.h"
+
+/**
+ * @brief A hash index from content text to list nodes.
+ * It can be attached to a singly or a doubly linked-list (the nodes
+ * are kept as void*) and is kept up to date by the list operations, so
+ * searching does not need to walk the list.
+ *
+ * Several nodes can have the same text. list_index_find returns one
+ * of them and list_index_find_next visits the others.
+ *
+ * Entries are chained per bucket and come from a list_pool, so adding
+ * and removing nodes does not call malloc once the pool is warm.
+ *
+ */
+typedef struct list_index_entry {
+    struct list_index_entry* next_ptr;
+    uint64_t hash;
+    void* node;
+    const my_content* content;
+} list_index_entry;
+
+typedef struct list_index {
+    list_index_entry** buckets;
+    size_t bucket_count;        // always a power of 2
+    size_t count;
+    list_pool* entries;
+} list_index;
+
+#define LIST_INDEX_MIN_BUCKETS 16
+
+/**
+ * @brief hash of the content text. It is kept in the content, so the
+ * text is not read again.
+ *
+ * @param content
+ * @return uint64_t
+ */
+static inline uint64_t list_index_hash(const my_content* content) {
+    return content->hash;
+}
+
+/**
+ * @brief making an empty index sized for a given number of nodes.
+ *
+ * @param expected_count
+ * @return list_index*
+ */
+static inline list_index* list_index_make(size_t expected_count) {
+    size_t bucket_count = LIST_INDEX_MIN_BUCKETS;
+    while (bucket_count < expected_count) {
+        bucket_count <<= 1;
+    }
+
+    list_index* index = malloc(sizeof(list_index));
+    index->buckets = calloc(bucket_count, sizeof(list_index_entry*));
+    index->bucket_count = bucket_count;
+    index->count = 0;
+    index->entries = list_pool_make(sizeof(list_index_entry), 0);
+    return index;
+}
+
+/**
+ * @brief doubling the bucket array once there are more entries than
+ * buckets. Entries are moved, not copied.
+ *
+ * @param index
+ */
+static inline void list_index_grow(list_index* index) {
+    size_t bucket_count = index->bucket_count << 1;
+    list_index_entry** buckets = calloc(bucket_count, sizeof(list_index_entry*));
+    for (size_t i = 0; i < index->bucket_count; i++) {
+        list_index_entry* entry = index->buckets[i];
+        while (entry != NULL) {
+            list_index_entry* next = entry->next_ptr;
+            size_t bucket = entry->hash & (bucket_count - 1);
+            entry->next_ptr = buckets[bucket];
+            buckets[bucket] = entry;
+            entry = next;
+        }
+    }
+    free(index->buckets);
+    index->buckets = buckets;
+    index->bucket_count = bucket_count;
+}
+
+/**
+ * @brief adding a node with its content to the index.
+ *
+ * @param index
+ * @param node
+ * @param content
+ */
+static inline void list_index_add(list_index* index, void* node, const my_content* content) {
+    if (index->count >= index->bucket_count) {
+        list_index_grow(index);
+    }
+
+    list_index_entry* entry = list_pool_alloc(index->entries);
+    entry->hash = list_index_hash(content);
+    entry->node = node;
+    entry->content = content;
+
+    size_t bucket = entry->hash & (index->bucket_count - 1);
+    entry->next_ptr = index->buckets[bucket];
+    index->buckets[bucket] = entry;
+    index->count++;
+}
+
+/**
+ * @brief removing a node from the index. The node is found by its
+ * content and told apart from other nodes with the same text by its
+ * address.
+ *
+ * @param index
+ * @param node
+ * @param content
+ */
+static inline void list_index_remove(list_index* index, void* node, const my_content* content) {
+    size_t bucket = list_index_hash(content) & (index->bucket_count - 1);
+    list_index_entry** link = &index->buckets[bucket];
+    while (*link != NULL) {
+        list_index_entry* entry = *link;
+        if (entry->node == node) {
+            *link = entry->next_ptr;
+            list_pool_release(index->entries, entry);
+            index->count--;
+            return;
+        }
+        link = &entry->next_ptr;
+    }
+}
+
+/**
+ * @brief the next entry after `entry` with the same text, NULL if
+ * there is none.
+ *
+ * @param entry
+ * @param content
+ * @return list_index_entry*
+ */
+static inline list_index_entry* list_index_find_next(list_index_entry* entry, const my_content* content) {
+    uint64_t hash = entry->hash;
+    for (entry = entry->next_ptr; entry != NULL; entry = entry->next_ptr) {
+        if (entry->hash == hash && content_equals(entry->content, content)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief an entry with the given text, NULL if there is none.
+ *
+ * @param index
+ * @param content
+ * @return list_index_entry*
+ */
+static inline list_index_entry* list_index_find(list_index* index, const my_content* content) {
+    uint64_t hash = list_index_hash(content);
+    list_index_entry* entry = index->buckets[hash & (index->bucket_count - 1)];
+    for (; entry != NULL; entry = entry->next_ptr) {
+        if (entry->hash == hash && content_equals(entry->content, content)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief removing all entries. The buckets are kept.
+ *
+ * @param index
+ */
+static inline void list_index_clear(list_index* index) {
+    memset(index->buckets, 0, index->bucket_count * sizeof(list_index_entry*));
+    list_pool_free(index->entries);
+    index->entries = list_pool_make(sizeof(list_index_entry), 0);
+    index->count = 0;
+}
+
+/**
+ * @brief freeing the index. The list nodes are not touched.
+ * return NULL when complete.
+ *
+ * @param index
+ * @return list_index*
+ */
+static inline list_index* list_index_free(list_index* index) {
+    if (index == NULL) {
+        return NULL;
+    }
+    list_pool_free(index->entries);
+    free(index->buckets);
+    free(index);
+    return NULL;
+}
+
+#endif
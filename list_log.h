@@ -0,0 +1,77 @@
+#ifndef LIST_LOG_H
+#define LIST_LOG_H
+
+#include <stdio.h>
+
+/**
+ * @brief Logging and status codes for the list code.
+ * The log level is picked at compile time, for example
+ *
+ *   cc -DLIST_LOG_LEVEL=LIST_LOG_DEBUG doubly-linked-list.c
+ *
+ * Messages above the level compile to nothing, their arguments are not
+ * even evaluated, so a disabled log costs nothing on the hot paths.
+ *
+ *   LIST_LOG_OFF    no messages
+ *   LIST_LOG_ERROR  bad arguments and failures (default)
+ *   LIST_LOG_DEBUG  also what every operation is doing
+ *
+ * Messages go to stderr.
+ *
+ */
+#define LIST_LOG_OFF 0
+#define LIST_LOG_ERROR 1
+#define LIST_LOG_DEBUG 2
+
+#ifndef LIST_LOG_LEVEL
+#define LIST_LOG_LEVEL LIST_LOG_ERROR
+#endif
+
+#if LIST_LOG_LEVEL >= LIST_LOG_ERROR
+#define LOG_ERROR(...) fprintf(stderr, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#if LIST_LOG_LEVEL >= LIST_LOG_DEBUG
+#define LOG_DEBUG(...) fprintf(stderr, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+/**
+ * @brief What the list operations return instead of printing errors.
+ *
+ */
+typedef enum list_status {
+    LIST_OK = 0,
+    LIST_ERR_NULL,          // a required argument is NULL
+    LIST_ERR_NOT_FOUND,     // the node to work on is not in the list
+    LIST_ERR_NO_MEMORY,
+    LIST_ERR_EXISTS,        // a set already holds the content
+    LIST_ERR_ORDER,         // the node would break the order of a sorted list
+    LIST_ERR_IO,            // a file could not be read or written
+    LIST_STOP,              // a callback asked to stop early; not an error
+} list_status;
+
+/**
+ * @brief A readable name for a status, for messages.
+ *
+ * @param status
+ * @return const char*
+ */
+static inline const char* list_status_name(list_status status) {
+    switch (status) {
+    case LIST_OK: return "ok";
+    case LIST_ERR_NULL: return "NULL argument";
+    case LIST_ERR_NOT_FOUND: return "not found";
+    case LIST_ERR_NO_MEMORY: return "out of memory";
+    case LIST_ERR_EXISTS: return "already exists";
+    case LIST_ERR_ORDER: return "out of order";
+    case LIST_ERR_IO: return "I/O error";
+    case LIST_STOP: return "stopped";
+    }
+    return "unknown";
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef LIST_POOL_H
+#define LIST_POOL_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+/**
+ * @brief A free-list node pool for the list nodes.
+ * Nodes are carved out of large blocks instead of calling malloc once
+ * per node. Released nodes go onto a free list and are handed out again
+ * by the next allocation, so a list that keeps inserting and removing
+ * does not touch the system allocator at all once it is warmed up.
+ *
+ * All nodes of one pool have the same size. A pool can be shared by
+ * several lists as long as their nodes have the same size.
+ *
+ */
+
+/**
+ * @brief Each block starts with this header, the nodes follow it.
+ *
+ */
+typedef struct list_pool_block {
+    struct list_pool_block* next_ptr;
+} list_pool_block;
+
+/**
+ * @brief A released node is reused to link the free list.
+ *
+ */
+typedef struct list_pool_free_node {
+    struct list_pool_free_node* next_ptr;
+} list_pool_free_node;
+
+typedef struct list_pool_stats {
+    size_t blocks_allocated;
+    size_t nodes_live;
+    size_t nodes_recycled;
+} list_pool_stats;
+
+typedef struct list_pool {
+    size_t node_size;
+    size_t nodes_per_block;
+    list_pool_block* blocks;
+    list_pool_free_node* free_list;
+    char* next_free;        // untouched space of the newest block
+    char* block_end;
+    list_pool_stats stats;
+} list_pool;
+
+#define LIST_POOL_DEFAULT_NODES_PER_BLOCK 4096
+
+/**
+ * @brief Round up to the alignment of max_align_t so every node
+ * (and the first node after the block header) is suitably aligned.
+ *
+ */
+static inline size_t list_pool_align(size_t size) {
+    size_t align = _Alignof(max_align_t);
+    return (size + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief making a pool of nodes of a given size.
+ *
+ * @cond node_size cannot be 0. nodes_per_block 0 means the default.
+ *
+ * @param node_size
+ * @param nodes_per_block
+ * @return list_pool*
+ */
+static inline list_pool* list_pool_make(size_t node_size, size_t nodes_per_block) {
+    if (node_size == 0) {
+        return NULL;
+    }
+    if (node_size < sizeof(list_pool_free_node)) {
+        node_size = sizeof(list_pool_free_node);
+    }
+
+    list_pool* pool = malloc(sizeof(list_pool));
+    pool->node_size = (node_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    pool->nodes_per_block = nodes_per_block ? nodes_per_block : LIST_POOL_DEFAULT_NODES_PER_BLOCK;
+    pool->blocks = NULL;
+    pool->free_list = NULL;
+    pool->next_free = NULL;
+    pool->block_end = NULL;
+    pool->stats.blocks_allocated = 0;
+    pool->stats.nodes_live = 0;
+    pool->stats.nodes_recycled = 0;
+    return pool;
+}
+
+/**
+ * @brief handing out a node. Recycled nodes are used first, then the
+ * rest of the newest block, and only then a new block is allocated.
+ *
+ * @param pool
+ * @return void* NULL when out of memory.
+ */
+static inline void* list_pool_alloc(list_pool* pool) {
+    if (pool->free_list != NULL) {
+        list_pool_free_node* node = pool->free_list;
+        pool->free_list = node->next_ptr;
+        pool->stats.nodes_live++;
+        pool->stats.nodes_recycled++;
+        return node;
+    }
+
+    if (pool->next_free == pool->block_end) {
+        size_t header = list_pool_align(sizeof(list_pool_block));
+        list_pool_block* block = malloc(header + pool->node_size * pool->nodes_per_block);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next_ptr = pool->blocks;
+        pool->blocks = block;
+        pool->next_free = (char*)block + header;
+        pool->block_end = pool->next_free + pool->node_size * pool->nodes_per_block;
+        pool->stats.blocks_allocated++;
+    }
+
+    void* node = pool->next_free;
+    pool->next_free += pool->node_size;
+    pool->stats.nodes_live++;
+    return node;
+}
+
+/**
+ * @brief giving a node back to the pool. The memory is kept and handed
+ * out again by list_pool_alloc.
+ *
+ * @param pool
+ * @param node
+ */
+static inline void list_pool_release(list_pool* pool, void* node) {
+    if (node == NULL) {
+        return;
+    }
+    list_pool_free_node* free_node = node;
+    free_node->next_ptr = pool->free_list;
+    pool->free_list = free_node;
+    pool->stats.nodes_live--;
+}
+
+static inline list_pool_stats list_pool_get_stats(list_pool* pool) {
+    return pool->stats;
+}
+
+/**
+ * @brief freeing every block of the pool. All nodes handed out by the
+ * pool become invalid. return NULL when complete.
+ *
+ * @param pool
+ * @return list_pool*
+ */
+static inline list_pool* list_pool_free(list_pool* pool) {
+    if (pool == NULL) {
+        return NULL;
+    }
+    list_pool_block* block = pool->blocks;
+    while (block != NULL) {
+        list_pool_block* next = block->next_ptr;
+        free(block);
+        block = next;
+    }
+    free(pool);
+    return NULL;
+}
+
+#endif
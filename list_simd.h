@@ -0,0 +1,136 @@
+#ifndef LIST_SIMD_H
+#define LIST_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Finding a hash in an array of content hashes, several hashes
+ * per instruction. A list that keeps the hashes of its contents next
+ * to each other (like the chunks of the unrolled list) can check a
+ * whole chunk this way and only reads the contents whose hash matches.
+ *
+ * There is an AVX2 (4 hashes per compare), an SSE2 (2 per compare) and
+ * a plain C version. list_simd_find_hash picks the best one the CPU
+ * runs, once, on its first call. Other compilers and machines get the
+ * plain C version only.
+ *
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LIST_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+typedef size_t (*list_simd_find_fn)(const uint64_t* hashes, size_t count, uint64_t hash);
+
+/**
+ * @brief the index of the first of `count` hashes equal to `hash`.
+ *
+ * @param hashes
+ * @param count
+ * @param hash
+ * @return size_t count when there is none.
+ */
+static inline size_t list_simd_find_hash_scalar(const uint64_t* hashes, size_t count, uint64_t hash) {
+    for (size_t i = 0; i < count; i++) {
+        if (hashes[i] == hash) {
+            return i;
+        }
+    }
+    return count;
+}
+
+#ifdef LIST_SIMD_X86
+/**
+ * @brief SSE2 has no 64-bit compare: both 32-bit halves must match, so
+ * the compare result is ANDed with itself with the halves swapped.
+ *
+ */
+__attribute__((target("sse2")))
+static inline size_t list_simd_find_hash_sse2(const uint64_t* hashes, size_t count, uint64_t hash) {
+    __m128i key = _mm_set1_epi64x((long long)hash);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i eq0 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(hashes + i)), key);
+        __m128i eq1 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(hashes + i + 2)), key);
+        eq0 = _mm_and_si128(eq0, _mm_shuffle_epi32(eq0, _MM_SHUFFLE(2, 3, 0, 1)));
+        eq1 = _mm_and_si128(eq1, _mm_shuffle_epi32(eq1, _MM_SHUFFLE(2, 3, 0, 1)));
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(eq0)) | _mm_movemask_pd(_mm_castsi128_pd(eq1)) << 2;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + list_simd_find_hash_scalar(hashes + i, count - i, hash);
+}
+
+__attribute__((target("avx2")))
+static inline size_t list_simd_find_hash_avx2(const uint64_t* hashes, size_t count, uint64_t hash) {
+    __m256i key = _mm256_set1_epi64x((long long)hash);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i eq0 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(hashes + i)), key);
+        __m256i eq1 = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(hashes + i + 4)), key);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq0)) | _mm256_movemask_pd(_mm256_castsi256_pd(eq1)) << 4;
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    if (i + 4 <= count) {
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(hashes + i)), key);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+        i += 4;
+    }
+    return i + list_simd_find_hash_scalar(hashes + i, count - i, hash);
+}
+#endif
+
+/**
+ * @brief the best version for this CPU and its name.
+ *
+ * @param name set to "avx2", "sse2" or "scalar"; may be NULL.
+ * @return list_simd_find_fn
+ */
+static inline list_simd_find_fn list_simd_select(const char** name) {
+    const char* selected = "scalar";
+    list_simd_find_fn find = list_simd_find_hash_scalar;
+#ifdef LIST_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        selected = "avx2";
+        find = list_simd_find_hash_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        selected = "sse2";
+        find = list_simd_find_hash_sse2;
+    }
+#endif
+    if (name != NULL) {
+        *name = selected;
+    }
+    return find;
+}
+
+/**
+ * @brief the index of the first of `count` hashes equal to `hash`,
+ * with the best version for this CPU. Threads that search for the
+ * first time at once may all pick it; they pick the same one, and the
+ * pointer is read and written atomically (relaxed).
+ *
+ * @param hashes
+ * @param count
+ * @param hash
+ * @return size_t count when there is none.
+ */
+static inline size_t list_simd_find_hash(const uint64_t* hashes, size_t count, uint64_t hash) {
+    static list_simd_find_fn find = NULL;
+    list_simd_find_fn selected = __atomic_load_n(&find, __ATOMIC_RELAXED);
+    if (selected == NULL) {
+        selected = list_simd_select(NULL);
+        __atomic_store_n(&find, selected, __ATOMIC_RELAXED);
+    }
+    return selected(hashes, count, hash);
+}
+
+#endif
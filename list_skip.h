@@ -0,0 +1,199 @@
+#ifndef LIST_SKIP_H
+#define LIST_SKIP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "my_content.h"
+
+/**
+ * @brief The upper levels of a skip list over a sorted linked-list.
+ * The list itself is the bottom level; only about one node in four gets
+ * a tower, and a tower of height h links that node on levels 1 to h.
+ * Finding the last tower before a content takes O(log n) on average,
+ * and from its node the list is at most a few nodes away from the
+ * place looked for (see dll_lower_bound).
+ *
+ * Like the hash index (list_index.h) it keeps the nodes as void* and
+ * is kept up to date by the list operations. Among nodes with the same
+ * text the towers may be in any order; searches only rely on towers of
+ * smaller texts coming first.
+ *
+ */
+#define LIST_SKIP_MAX_LEVEL 16      // enough for 4^16 nodes
+
+typedef struct list_skip_tower {
+    void* node;
+    const my_content* content;
+    size_t height;
+    struct list_skip_tower* next[];
+} list_skip_tower;
+
+typedef struct list_skip {
+    list_skip_tower* heads[LIST_SKIP_MAX_LEVEL];
+    size_t level;               // height of the highest tower
+    size_t count;               // number of towers
+    uint64_t seed;
+} list_skip;
+
+static inline list_skip* list_skip_make() {
+    list_skip* skip = calloc(1, sizeof(list_skip));
+    skip->seed = 88172645463325252ULL;
+    return skip;
+}
+
+/**
+ * @brief a random tower height: 0 (no tower) with probability 3/4, then
+ * each further level with probability 1/4.
+ *
+ */
+static inline size_t list_skip_random_height(list_skip* skip) {
+    skip->seed ^= skip->seed << 13;
+    skip->seed ^= skip->seed >> 7;
+    skip->seed ^= skip->seed << 17;
+    uint64_t bits = skip->seed;
+    size_t height = 0;
+    while ((bits & 3) == 0 && height < LIST_SKIP_MAX_LEVEL) {
+        height++;
+        bits >>= 2;
+    }
+    return height;
+}
+
+/**
+ * @brief the last tower whose content is smaller than `content` (or not
+ * greater when `inclusive`), NULL when there is none.
+ *
+ * @param skip
+ * @param content
+ * @param inclusive
+ * @param before when not NULL, gets the last such tower on every level.
+ * @return list_skip_tower*
+ */
+static inline list_skip_tower* list_skip_find_before(list_skip* skip, const my_content* content,
+        bool inclusive, list_skip_tower** before) {
+    list_skip_tower* tower = NULL;
+    for (size_t l = skip->level; l-- > 0;) {
+        list_skip_tower* next = tower != NULL ? tower->next[l] : skip->heads[l];
+        while (next != NULL) {
+            int order = content_compare(next->content, content);
+            if (order > 0 || (order == 0 && !inclusive)) {
+                break;
+            }
+            tower = next;
+            next = next->next[l];
+        }
+        if (before != NULL) {
+            before[l] = tower;
+        }
+    }
+    return tower;
+}
+
+/**
+ * @brief giving a node just linked in the list its tower, if the draw
+ * gives it one.
+ *
+ * @cond the list must be sorted with the node in it.
+ *
+ * @param skip
+ * @param node
+ * @param content
+ */
+static inline void list_skip_add(list_skip* skip, void* node, const my_content* content) {
+    size_t height = list_skip_random_height(skip);
+    if (height == 0) {
+        return;
+    }
+
+    list_skip_tower* before[LIST_SKIP_MAX_LEVEL];
+    list_skip_find_before(skip, content, false, before);
+    for (size_t l = skip->level; l < height; l++) {
+        before[l] = NULL;
+    }
+    if (height > skip->level) {
+        skip->level = height;
+    }
+
+    list_skip_tower* tower = malloc(sizeof(list_skip_tower) + height * sizeof(list_skip_tower*));
+    tower->node = node;
+    tower->content = content;
+    tower->height = height;
+    for (size_t l = 0; l < height; l++) {
+        list_skip_tower** link = before[l] != NULL ? &before[l]->next[l] : &skip->heads[l];
+        tower->next[l] = *link;
+        *link = tower;
+    }
+    skip->count++;
+}
+
+/**
+ * @brief taking the tower of a node away, if it has one. The node is
+ * found by its content and told apart from other nodes with the same
+ * text by its address.
+ *
+ * @param skip
+ * @param node
+ * @param content
+ */
+static inline void list_skip_remove(list_skip* skip, void* node, const my_content* content) {
+    list_skip_tower* before[LIST_SKIP_MAX_LEVEL];
+    list_skip_tower* first = list_skip_find_before(skip, content, false, before);
+    list_skip_tower* tower = first != NULL ? first->next[0] : skip->heads[0];
+    while (tower != NULL && tower->node != node && content_compare(tower->content, content) == 0) {
+        tower = tower->next[0];
+    }
+    if (tower == NULL || tower->node != node) {
+        return;
+    }
+
+    for (size_t l = 0; l < tower->height; l++) {
+        list_skip_tower** link = before[l] != NULL ? &before[l]->next[l] : &skip->heads[l];
+        while (*link != tower) {
+            link = &(*link)->next[l];
+        }
+        *link = tower->next[l];
+    }
+    while (skip->level > 0 && skip->heads[skip->level - 1] == NULL) {
+        skip->level--;
+    }
+    free(tower);
+    skip->count--;
+}
+
+/**
+ * @brief freeing all towers. The list nodes are not touched.
+ *
+ * @param skip
+ */
+static inline void list_skip_clear(list_skip* skip) {
+    list_skip_tower* tower = skip->heads[0];
+    while (tower != NULL) {
+        list_skip_tower* next = tower->next[0];
+        free(tower);
+        tower = next;
+    }
+    for (size_t l = 0; l < LIST_SKIP_MAX_LEVEL; l++) {
+        skip->heads[l] = NULL;
+    }
+    skip->level = 0;
+    skip->count = 0;
+}
+
+/**
+ * @brief freeing the skip list. The list nodes are not touched.
+ * return NULL when complete.
+ *
+ * @param skip
+ * @return list_skip*
+ */
+static inline list_skip* list_skip_free(list_skip* skip) {
+    if (skip == NULL) {
+        return NULL;
+    }
+    list_skip_clear(skip);
+    free(skip);
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef LIST_STATS_H
+#define LIST_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Counters for what the list code allocates and walks. They are
+ * compiled in on request, for example
+ *
+ *   cc -DLIST_STATS singly-linked-list.c
+ *
+ * Without LIST_STATS every LIST_STATS_ADD compiles to nothing, so the
+ * counters cost nothing on the hot paths.
+ *
+ *   contents  made by content_make and freed by content_free; contents
+ *             embedded in a node or an arena are part of the node
+ *   nodes     made and released by the singly and the doubly
+ *             linked-list, from malloc, a pool, an arena or a file load
+ *   visits    nodes looked at by sll_search / dll_search_node and by
+ *             sll_insert_node / sll_remove_node looking for the node
+ *             before `at`: a large visits per call ratio is an O(n) hot
+ *             spot, a growing live count a leak
+ *
+ * The counters are updated with relaxed atomic adds, so threads can
+ * share them. A snapshot read while other threads count is not exact.
+ *
+ */
+typedef struct list_stats {
+    size_t content_allocs;
+    size_t content_frees;
+    size_t content_bytes;       // allocated, in total
+    size_t node_allocs;
+    size_t node_frees;
+    size_t node_bytes;          // allocated, in total
+    size_t searches;
+    size_t search_visits;
+    size_t inserts;
+    size_t insert_visits;
+    size_t removes;
+    size_t remove_visits;
+} list_stats;
+
+#ifdef LIST_STATS
+static list_stats list_stats_counters;
+
+#define LIST_STATS_ADD(field, n) __atomic_fetch_add(&list_stats_counters.field, (n), __ATOMIC_RELAXED)
+#else
+#define LIST_STATS_ADD(field, n) ((void)(n))
+#endif
+
+/**
+ * @brief true when the counters are compiled in.
+ *
+ */
+static inline bool list_stats_enabled() {
+#ifdef LIST_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief a copy of the counters, all 0 when they are compiled out.
+ *
+ * @return list_stats
+ */
+static inline list_stats list_stats_snapshot() {
+    list_stats stats = { 0 };
+#ifdef LIST_STATS
+    size_t* from = (size_t*)&list_stats_counters;
+    size_t* to = (size_t*)&stats;
+    for (size_t i = 0; i < sizeof(list_stats) / sizeof(size_t); i++) {
+        to[i] = __atomic_load_n(&from[i], __ATOMIC_RELAXED);
+    }
+#endif
+    return stats;
+}
+
+/**
+ * @brief setting every counter back to 0.
+ *
+ */
+static inline void list_stats_reset() {
+#ifdef LIST_STATS
+    size_t* counters = (size_t*)&list_stats_counters;
+    for (size_t i = 0; i < sizeof(list_stats) / sizeof(size_t); i++) {
+        __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+    }
+#endif
+}
+
+/**
+ * @brief printing a snapshot, with the live counts and the visits per
+ * call worked out.
+ *
+ * @param out
+ * @param stats
+ */
+static inline void list_stats_dump(FILE* out, const list_stats* stats) {
+    if (!list_stats_enabled()) {
+        fprintf(out, "list stats are off (build with -DLIST_STATS)\n");
+        return;
+    }
+    fprintf(out, "contents: %zu made, %zu freed, %zu live, %zu bytes made\n", stats->content_allocs,
+        stats->content_frees, stats->content_allocs - stats->content_frees, stats->content_bytes);
+    fprintf(out, "nodes:    %zu made, %zu freed, %zu live, %zu bytes made\n", stats->node_allocs,
+        stats->node_frees, stats->node_allocs - stats->node_frees, stats->node_bytes);
+    fprintf(out, "search:   %zu calls, %zu nodes visited, %.1f per call\n", stats->searches,
+        stats->search_visits, stats->searches > 0 ? (double)stats->search_visits / stats->searches : 0.0);
+    fprintf(out, "insert:   %zu calls, %zu nodes visited, %.1f per call\n", stats->inserts,
+        stats->insert_visits, stats->inserts > 0 ? (double)stats->insert_visits / stats->inserts : 0.0);
+    fprintf(out, "remove:   %zu calls, %zu nodes visited, %.1f per call\n", stats->removes,
+        stats->remove_visits, stats->removes > 0 ? (double)stats->remove_visits / stats->removes : 0.0);
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef LIST_STREAM_H
+#define LIST_STREAM_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "list_log.h"
+
+/**
+ * @brief Reading newline-delimited text from a file descriptor in large
+ * read() chunks. Lines are found with memchr in the chunk and handed
+ * out in place, without a stdio call or a copy per line.
+ *
+ * A line that is cut by the end of a chunk is moved to the front of the
+ * buffer before the next read; a line longer than the buffer makes the
+ * buffer grow. "\n" and "\r\n" both end a line, and a last line without
+ * a newline is a line too.
+ *
+ */
+#define LIST_STREAM_CHUNK (1024 * 1024)
+
+typedef struct list_stream {
+    int fd;
+    char* buffer;
+    size_t capacity;
+    size_t start;       // first byte not handed out yet
+    size_t scanned;     // bytes after start known to hold no newline
+    size_t end;         // end of the bytes read
+    bool eof;
+    bool failed;        // a read() failed
+} list_stream;
+
+/**
+ * @brief setting up a stream over an open file descriptor. The
+ * descriptor is not closed by the stream.
+ *
+ * @param stream
+ * @param fd
+ * @param chunk_size bytes per read(), 0 for LIST_STREAM_CHUNK.
+ */
+static inline void list_stream_init(list_stream* stream, int fd, size_t chunk_size) {
+    stream->fd = fd;
+    stream->capacity = chunk_size > 0 ? chunk_size : LIST_STREAM_CHUNK;
+    stream->buffer = malloc(stream->capacity);
+    stream->start = 0;
+    stream->scanned = 0;
+    stream->end = 0;
+    stream->eof = false;
+    stream->failed = stream->buffer == NULL;
+}
+
+/**
+ * @brief the next line, without its line end.
+ *
+ * @param stream
+ * @param line set to the text, valid until the next call. It is not
+ * '\0' terminated.
+ * @param length set to the length of the text.
+ * @return true for a line, false at the end of the input or when
+ * reading failed (see stream->failed).
+ */
+static inline bool list_stream_next_line(list_stream* stream, const char** line, size_t* length) {
+    while (!stream->failed) {
+        char* begin = stream->buffer + stream->start;
+        char* newline = memchr(begin + stream->scanned, '\n', stream->end - stream->start - stream->scanned);
+        if (newline != NULL || (stream->eof && stream->start < stream->end)) {
+            size_t size = newline != NULL ? (size_t)(newline - begin) : stream->end - stream->start;
+            stream->start += newline != NULL ? size + 1 : size;
+            stream->scanned = 0;
+            if (newline != NULL && size > 0 && begin[size - 1] == '\r') {
+                size--;
+            }
+            *line = begin;
+            *length = size;
+            return true;
+        }
+        if (stream->eof) {
+            return false;
+        }
+
+        // keep the start of a cut line and read behind it.
+        stream->scanned = stream->end - stream->start;
+        if (stream->start > 0) {
+            memmove(stream->buffer, begin, stream->end - stream->start);
+            stream->end -= stream->start;
+            stream->start = 0;
+        }
+        if (stream->end == stream->capacity) {
+            char* buffer = realloc(stream->buffer, stream->capacity * 2);
+            if (buffer == NULL) {
+                stream->failed = true;
+                break;
+            }
+            stream->buffer = buffer;
+            stream->capacity *= 2;
+        }
+        ssize_t count = read(stream->fd, stream->buffer + stream->end, stream->capacity - stream->end);
+        if (count < 0 && errno != EINTR) {
+            LOG_ERROR("reading the stream failed!\n");
+            stream->failed = true;
+        } else if (count == 0) {
+            stream->eof = true;
+        } else if (count > 0) {
+            stream->end += count;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief freeing the buffer of the stream.
+ *
+ * @param stream
+ */
+static inline void list_stream_release(list_stream* stream) {
+    free(stream->buffer);
+    stream->buffer = NULL;
+}
+
+#endif
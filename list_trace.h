@@ -0,0 +1,251 @@
+#ifndef LIST_TRACE_H
+#define LIST_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * @brief Latency histograms for the list operations. Tracing is
+ * compiled in on request, for example
+ *
+ *   cc -DLIST_TRACE doubly-linked-list.c
+ *
+ * and then every traced call (append, insert, search, remove and
+ * remove-all of the singly and the doubly linked-list) adds its time to
+ * a histogram per operation and list size (in powers of 10). Prepending,
+ * inserting after a node, through a cursor or in sorted order count as
+ * inserts, clearing as a remove-all. An operation built on another one
+ * is recorded once. Without LIST_TRACE, LIST_TRACE_OP compiles to
+ * nothing.
+ *
+ * LIST_TRACE_OP goes at the top of a function, once the arguments are
+ * checked. It reads the clock and leaves a variable behind whose
+ * cleanup (__attribute__((cleanup))) reads the clock again and records
+ * the time when the function returns, by any return.
+ *
+ * The clock is the time stamp counter on x86 (a few ns to read) and
+ * clock_gettime(CLOCK_MONOTONIC) elsewhere. Times are kept in clock
+ * ticks and turned into ns when reported. The histograms have 4
+ * buckets per power of 2, so a reported percentile is within about 12%
+ * of the real one. Buckets are counted with relaxed atomic adds, so
+ * threads can share them.
+ *
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define LIST_TRACE_TSC 1
+#endif
+
+typedef enum list_trace_op {
+    LIST_TRACE_APPEND,
+    LIST_TRACE_INSERT,
+    LIST_TRACE_SEARCH,
+    LIST_TRACE_REMOVE,
+    LIST_TRACE_REMOVE_ALL,
+    LIST_TRACE_OP_COUNT,
+} list_trace_op;
+
+#define LIST_TRACE_SIZES 8          // < 10, < 100, ..., >= 10^7 nodes
+#define LIST_TRACE_BUCKETS 252      // 4 per power of 2 of a 64-bit time
+
+typedef struct list_trace_span {
+    uint64_t start;
+    unsigned op;
+    unsigned size;
+} list_trace_span;
+
+static uint64_t list_trace_counts[LIST_TRACE_OP_COUNT][LIST_TRACE_SIZES][LIST_TRACE_BUCKETS];
+
+static const char* list_trace_op_names[LIST_TRACE_OP_COUNT] = {
+    "append", "insert", "search", "remove", "remove-all",
+};
+
+static inline uint64_t list_trace_now() {
+#ifdef LIST_TRACE_TSC
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief the bucket of a time: 0-3 for 0-3 ticks, then 4 buckets per
+ * power of 2.
+ *
+ */
+static inline unsigned list_trace_bucket(uint64_t ticks) {
+    if (ticks < 4) {
+        return (unsigned)ticks;
+    }
+    unsigned octave = 63 - __builtin_clzll(ticks);
+    return 4 * (octave - 1) + (unsigned)((ticks >> (octave - 2)) & 3);
+}
+
+/**
+ * @brief the middle of a bucket, in ticks.
+ *
+ */
+static inline double list_trace_bucket_ticks(unsigned bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    unsigned octave = bucket / 4 + 1;
+    double low = (double)((uint64_t)(4 + bucket % 4) << (octave - 2));
+    return low + (double)((uint64_t)1 << (octave - 2)) / 2;
+}
+
+/**
+ * @brief the size bucket of a list of `count` nodes.
+ *
+ */
+static inline unsigned list_trace_size(size_t count) {
+    unsigned size = 0;
+    while (count >= 10 && size < LIST_TRACE_SIZES - 1) {
+        count /= 10;
+        size++;
+    }
+    return size;
+}
+
+static inline list_trace_span list_trace_begin(list_trace_op op, size_t count) {
+    list_trace_span span = { list_trace_now(), op, list_trace_size(count) };
+    return span;
+}
+
+static inline void list_trace_end(list_trace_span* span) {
+    uint64_t ticks = list_trace_now() - span->start;
+    __atomic_fetch_add(&list_trace_counts[span->op][span->size][list_trace_bucket(ticks)], 1, __ATOMIC_RELAXED);
+}
+
+#ifdef LIST_TRACE
+#define LIST_TRACE_OP(op, count) \
+    list_trace_span list_trace_span_ __attribute__((cleanup(list_trace_end))) = list_trace_begin((op), (count))
+#else
+#define LIST_TRACE_OP(op, count) ((void)0)
+#endif
+
+/**
+ * @brief true when tracing is compiled in.
+ *
+ */
+static inline bool list_trace_enabled() {
+#ifdef LIST_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief clock ticks per ns, measured against CLOCK_MONOTONIC over
+ * 10 ms the first time it is needed (1 without a time stamp counter).
+ *
+ */
+static inline double list_trace_ticks_per_ns() {
+#ifdef LIST_TRACE_TSC
+    static double ticks_per_ns = 0;
+    if (ticks_per_ns == 0) {
+        struct timespec start, now;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        uint64_t ticks = __rdtsc();
+        double ns;
+        do {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            ns = (now.tv_sec - start.tv_sec) * 1e9 + (now.tv_nsec - start.tv_nsec);
+        } while (ns < 1e7);
+        ticks_per_ns = (__rdtsc() - ticks) / ns;
+    }
+    return ticks_per_ns;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief the number of traced calls of an operation on lists of a
+ * size bucket.
+ *
+ */
+static inline uint64_t list_trace_count(list_trace_op op, unsigned size) {
+    uint64_t total = 0;
+    for (unsigned b = 0; b < LIST_TRACE_BUCKETS; b++) {
+        total += __atomic_load_n(&list_trace_counts[op][size][b], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+/**
+ * @brief the time (ns) that a fraction q of the traced calls of an
+ * operation on lists of a size bucket took at most.
+ *
+ * @param op
+ * @param size size bucket: 0 for < 10 nodes, 1 for < 100, ...
+ * @param q for example 0.99 for p99.
+ * @return double 0 when nothing was traced.
+ */
+static inline double list_trace_percentile(list_trace_op op, unsigned size, double q) {
+    uint64_t total = list_trace_count(op, size);
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(q * total);
+    rank = rank < total ? rank : total - 1;
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < LIST_TRACE_BUCKETS; b++) {
+        seen += __atomic_load_n(&list_trace_counts[op][size][b], __ATOMIC_RELAXED);
+        if (seen > rank) {
+            return list_trace_bucket_ticks(b) / list_trace_ticks_per_ns();
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief forgetting everything traced so far.
+ *
+ */
+static inline void list_trace_reset() {
+    uint64_t* counts = &list_trace_counts[0][0][0];
+    for (size_t i = 0; i < sizeof(list_trace_counts) / sizeof(uint64_t); i++) {
+        __atomic_store_n(&counts[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief printing p50, p99 and p999 for every operation and size bucket
+ * that has traced calls.
+ *
+ * @param out
+ */
+static inline void list_trace_dump(FILE* out) {
+    if (!list_trace_enabled()) {
+        fprintf(out, "list tracing is off (build with -DLIST_TRACE)\n");
+        return;
+    }
+    fprintf(out, "%-10s %10s %12s %10s %10s %10s\n", "operation", "nodes <", "calls", "p50 ns", "p99 ns", "p999 ns");
+    for (unsigned op = 0; op < LIST_TRACE_OP_COUNT; op++) {
+        size_t limit = 10;
+        for (unsigned size = 0; size < LIST_TRACE_SIZES; size++, limit *= 10) {
+            uint64_t calls = list_trace_count(op, size);
+            if (calls == 0) {
+                continue;
+            }
+            char nodes[24];
+            if (size < LIST_TRACE_SIZES - 1) {
+                snprintf(nodes, sizeof(nodes), "%zu", limit);
+            } else {
+                snprintf(nodes, sizeof(nodes), "more");
+            }
+            fprintf(out, "%-10s %10s %12llu %10.0f %10.0f %10.0f\n", list_trace_op_names[op], nodes,
+                (unsigned long long)calls, list_trace_percentile(op, size, 0.5),
+                list_trace_percentile(op, size, 0.99), list_trace_percentile(op, size, 0.999));
+        }
+    }
+}
+
+#endif
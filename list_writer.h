@@ -0,0 +1,225 @@
+#ifndef LIST_WRITER_H
+#define LIST_WRITER_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "list_log.h"
+#include "my_content.h"
+
+/**
+ * @brief Writing list contents in bulk. Text is gathered in one large
+ * buffer and handed to the file descriptor with write() (or to the
+ * FILE* with fwrite()) once the buffer is full, so dumping a list takes
+ * a few system calls instead of one printf per node. Numbers are
+ * formatted by hand, without the printf machinery.
+ *
+ * ANSI colors (ansi_color_codes.h) go through list_writer_color and
+ * are dropped when the writer was told so, or, with LIST_COLOR_AUTO,
+ * when the output is not a terminal.
+ *
+ * A writer to a FILE* keeps the order with other output to that FILE*.
+ * A writer to a file descriptor does not know about stdio: flush a
+ * FILE* on the same descriptor before writing.
+ *
+ */
+#define LIST_WRITER_BUFFER (64 * 1024)
+
+typedef enum list_writer_colors {
+    LIST_COLOR_AUTO,        // colors only on a terminal
+    LIST_COLOR_ALWAYS,
+    LIST_COLOR_NEVER,
+} list_writer_colors;
+
+typedef struct list_writer {
+    int fd;             // -1 when writing to file
+    FILE* file;
+    char* buffer;
+    size_t capacity;
+    size_t used;
+    bool color;
+    bool failed;        // a write failed; later output is dropped
+} list_writer;
+
+static inline void list_writer_setup(list_writer* writer, int fd, FILE* file, list_writer_colors colors) {
+    writer->fd = fd;
+    writer->file = file;
+    writer->buffer = malloc(LIST_WRITER_BUFFER);
+    writer->capacity = writer->buffer != NULL ? LIST_WRITER_BUFFER : 0;
+    writer->used = 0;
+    writer->failed = writer->buffer == NULL;
+    if (colors == LIST_COLOR_AUTO) {
+        writer->color = isatty(file != NULL ? fileno(file) : fd);
+    } else {
+        writer->color = colors == LIST_COLOR_ALWAYS;
+    }
+}
+
+/**
+ * @brief setting up a writer to an open file descriptor. The
+ * descriptor is not closed by the writer.
+ *
+ * @param writer
+ * @param fd
+ * @param colors
+ */
+static inline void list_writer_init_fd(list_writer* writer, int fd, list_writer_colors colors) {
+    list_writer_setup(writer, fd, NULL, colors);
+}
+
+/**
+ * @brief setting up a writer to a FILE*, like stdout. The FILE* is not
+ * closed by the writer.
+ *
+ * @param writer
+ * @param file
+ * @param colors
+ */
+static inline void list_writer_init_file(list_writer* writer, FILE* file, list_writer_colors colors) {
+    list_writer_setup(writer, -1, file, colors);
+}
+
+static inline void list_writer_out(list_writer* writer, const char* data, size_t size) {
+    if (writer->file != NULL) {
+        if (fwrite(data, 1, size, writer->file) != size) {
+            writer->failed = true;
+        }
+        return;
+    }
+    while (size > 0) {
+        ssize_t count = write(writer->fd, data, size);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            writer->failed = true;
+            return;
+        }
+        data += count;
+        size -= count;
+    }
+}
+
+/**
+ * @brief handing the buffered text to the output.
+ *
+ * @param writer
+ * @return list_status LIST_ERR_IO when any write failed so far.
+ */
+static inline list_status list_writer_flush(list_writer* writer) {
+    if (writer->used > 0 && !writer->failed) {
+        list_writer_out(writer, writer->buffer, writer->used);
+    }
+    writer->used = 0;
+    return writer->failed ? LIST_ERR_IO : LIST_OK;
+}
+
+/**
+ * @brief adding `length` bytes of text. A text larger than the buffer
+ * is written directly.
+ *
+ * @param writer
+ * @param text
+ * @param length
+ */
+static inline void list_writer_text(list_writer* writer, const char* text, size_t length) {
+    if (writer->capacity - writer->used < length) {
+        list_writer_flush(writer);
+        if (length > writer->capacity) {
+            if (!writer->failed) {
+                list_writer_out(writer, text, length);
+            }
+            return;
+        }
+    }
+    memcpy(writer->buffer + writer->used, text, length);
+    writer->used += length;
+}
+
+static inline void list_writer_string(list_writer* writer, const char* text) {
+    list_writer_text(writer, text, strlen(text));
+}
+
+/**
+ * @brief adding an ANSI color code, unless colors are off.
+ *
+ * @param writer
+ * @param code
+ */
+static inline void list_writer_color(list_writer* writer, const char* code) {
+    if (writer->color) {
+        list_writer_string(writer, code);
+    }
+}
+
+/**
+ * @brief adding a number in decimal.
+ *
+ * @param writer
+ * @param number
+ */
+static inline void list_writer_number(list_writer* writer, size_t number) {
+    char digits[20];
+    size_t start = sizeof(digits);
+    do {
+        digits[--start] = '0' + number % 10;
+        number /= 10;
+    } while (number > 0);
+    list_writer_text(writer, digits + start, sizeof(digits) - start);
+}
+
+/**
+ * @brief adding a list line "<number>. <text>\n".
+ *
+ * @param writer
+ * @param number
+ * @param content
+ */
+static inline void list_writer_node(list_writer* writer, size_t number, const my_content* content) {
+    if (writer->capacity - writer->used >= content->length + 23) {
+        // the common case: everything fits, no checks per piece.
+        char* out = writer->buffer + writer->used;
+        char digits[20];
+        size_t start = sizeof(digits);
+        do {
+            digits[--start] = '0' + number % 10;
+            number /= 10;
+        } while (number > 0);
+        memcpy(out, digits + start, sizeof(digits) - start);
+        out += sizeof(digits) - start;
+        *out++ = '.';
+        *out++ = ' ';
+        memcpy(out, content->text, content->length);
+        out += content->length;
+        *out++ = '\n';
+        writer->used = out - writer->buffer;
+        return;
+    }
+    list_writer_number(writer, number);
+    list_writer_text(writer, ". ", 2);
+    list_writer_text(writer, content->text, content->length);
+    list_writer_text(writer, "\n", 1);
+}
+
+/**
+ * @brief flushing and freeing the buffer of the writer. Text handed to
+ * a FILE* may still sit in the FILE*'s own buffer.
+ *
+ * @param writer
+ * @return list_status LIST_ERR_IO when any write failed.
+ */
+static inline list_status list_writer_release(list_writer* writer) {
+    list_status status = list_writer_flush(writer);
+    free(writer->buffer);
+    writer->buffer = NULL;
+    writer->capacity = 0;
+    if (status != LIST_OK) {
+        LOG_ERROR("writing the list failed!\n");
+    }
+    return status;
+}
+
+#endif
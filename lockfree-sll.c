@@ -0,0 +1,484 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "list_log.h"
+#include "my_content.h"
+#include "hazard_ptr.h"
+
+/**
+ * @brief Example of a lock-free singly linked-list.
+ * The list is a sorted set of contents that many threads can insert
+ * into, search and remove from at the same time without a lock
+ * (Harris' list, in Michael's version with hazard pointers).
+ *
+ * Removing a node takes two steps: the low bit of its next_ptr is set
+ * first (the node is logically deleted and no thread links anything
+ * behind it any more), then the node is unlinked by whichever thread
+ * gets there first. Unlinked nodes are retired to the hazard pointer
+ * domain of the list and freed once no thread is reading them.
+ *
+ * A thread calls lf_sll_enter before working on a list and passes the
+ * record it gets to every operation, lf_sll_leave when it is done.
+ *
+ * Build with -pthread.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+/**
+ * @brief The node carries its content right behind it, like the text
+ * nodes of my_sll, so a node is one allocation and one free.
+ *
+ */
+typedef struct lf_sll {
+    _Atomic(uintptr_t) next_ptr;    // lf_sll*, low bit set: this node is deleted
+    my_content* content;
+} lf_sll;
+
+typedef struct lf_sll_list {
+    _Atomic(uintptr_t) head;
+    atomic_size_t count;
+    hp_domain* domain;
+} lf_sll_list;
+
+#define LF_SLL_MARK ((uintptr_t)1)
+
+// hazard slots used while walking the list
+#define LF_SLL_HP_NEXT 0
+#define LF_SLL_HP_CUR 1
+#define LF_SLL_HP_PREV 2
+
+static inline lf_sll* lf_sll_ptr(uintptr_t link) {
+    return (lf_sll*)(link & ~LF_SLL_MARK);
+}
+
+static inline bool lf_sll_is_marked(uintptr_t link) {
+    return (link & LF_SLL_MARK) != 0;
+}
+
+static void lf_sll_reclaim(void* node) {
+    free(node);
+}
+
+/**
+ * @brief making an empty list.
+ *
+ * @return lf_sll_list*
+ */
+lf_sll_list* lf_sll_make() {
+    lf_sll_list* list = malloc(sizeof(lf_sll_list));
+    atomic_init(&list->head, 0);
+    atomic_init(&list->count, 0);
+    list->domain = hp_domain_make();
+    return list;
+}
+
+/**
+ * @brief taking a thread record for working on the list.
+ *
+ * @param list
+ * @return hp_thread* NULL when HP_MAX_THREADS threads use the list.
+ */
+hp_thread* lf_sll_enter(lf_sll_list* list) {
+    hp_thread* thread = hp_thread_enter(list->domain);
+    if (thread == NULL) {
+        LOG_ERROR("too many threads on the list!\n");
+    }
+    return thread;
+}
+
+void lf_sll_leave(lf_sll_list* list, hp_thread* thread) {
+    hp_thread_leave(list->domain, thread);
+}
+
+/**
+ * @brief finding the position of a content: `*prev` is the link that
+ * points at `*cur`, the first node not less than the content. Marked
+ * nodes met on the way are unlinked. On return prev's node and cur are
+ * protected by hazards.
+ *
+ * @return true when cur holds the content.
+ */
+static bool lf_sll_find(lf_sll_list* list, hp_thread* thread, const my_content* content,
+        _Atomic(uintptr_t)** prev_out, lf_sll** cur_out, uintptr_t* next_out) {
+retry:;
+    _Atomic(uintptr_t)* prev = &list->head;
+    lf_sll* cur = lf_sll_ptr(hp_protect(thread, LF_SLL_HP_CUR, prev));
+    for (;;) {
+        if (cur == NULL) {
+            *prev_out = prev;
+            *cur_out = NULL;
+            *next_out = 0;
+            return false;
+        }
+
+        uintptr_t next = hp_protect(thread, LF_SLL_HP_NEXT, &cur->next_ptr);
+        // prev must still point at cur, unmarked, or cur may be gone.
+        if (atomic_load(prev) != (uintptr_t)cur) {
+            goto retry;
+        }
+
+        if (lf_sll_is_marked(next)) {
+            uintptr_t expected = (uintptr_t)cur;
+            if (!atomic_compare_exchange_strong(prev, &expected, next & ~LF_SLL_MARK)) {
+                goto retry;
+            }
+            hp_retire(list->domain, thread, cur, lf_sll_reclaim);
+        } else {
+            int order = content_compare(cur->content, content);
+            if (order >= 0) {
+                *prev_out = prev;
+                *cur_out = cur;
+                *next_out = next;
+                return order == 0;
+            }
+            prev = &cur->next_ptr;
+            hp_set(thread, LF_SLL_HP_PREV, cur);
+        }
+        cur = lf_sll_ptr(next);
+        hp_set(thread, LF_SLL_HP_CUR, cur);
+    }
+}
+
+/**
+ * @brief adding a text to the set.
+ *
+ * @param list
+ * @param thread
+ * @param text
+ * @return list_status LIST_ERR_EXISTS when the text is in the set.
+ */
+list_status lf_sll_insert(lf_sll_list* list, hp_thread* thread, const char* text) {
+    if (list == NULL || thread == NULL || text == NULL) {
+        LOG_ERROR("list, thread or text is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    size_t length = strlen(text);
+    lf_sll* node = malloc(sizeof(lf_sll) + CONTENT_SIZE(length));
+    if (node == NULL) {
+        return LIST_ERR_NO_MEMORY;
+    }
+    node->content = content_init(node + 1, text, length);
+
+    list_status status = LIST_OK;
+    for (;;) {
+        _Atomic(uintptr_t)* prev;
+        lf_sll* cur;
+        uintptr_t next;
+        if (lf_sll_find(list, thread, node->content, &prev, &cur, &next)) {
+            free(node);
+            status = LIST_ERR_EXISTS;
+            break;
+        }
+        atomic_store_explicit(&node->next_ptr, (uintptr_t)cur, memory_order_relaxed);
+        uintptr_t expected = (uintptr_t)cur;
+        if (atomic_compare_exchange_strong(prev, &expected, (uintptr_t)node)) {
+            atomic_fetch_add_explicit(&list->count, 1, memory_order_relaxed);
+            break;
+        }
+    }
+    hp_clear(thread);
+    return status;
+}
+
+/**
+ * @brief searching for a content. The answer is true or false at some
+ * point during the call.
+ *
+ * @param list
+ * @param thread
+ * @param content
+ * @return true
+ * @return false
+ */
+bool lf_sll_contains(lf_sll_list* list, hp_thread* thread, const my_content* content) {
+    if (list == NULL || thread == NULL || content == NULL) {
+        LOG_ERROR("list, thread or content is NULL!\n");
+        return false;
+    }
+
+    _Atomic(uintptr_t)* prev;
+    lf_sll* cur;
+    uintptr_t next;
+    bool found = lf_sll_find(list, thread, content, &prev, &cur, &next);
+    hp_clear(thread);
+    return found;
+}
+
+/**
+ * @brief removing a content from the set.
+ *
+ * @param list
+ * @param thread
+ * @param content
+ * @return list_status LIST_ERR_NOT_FOUND when it is not in the set.
+ */
+list_status lf_sll_remove(lf_sll_list* list, hp_thread* thread, const my_content* content) {
+    if (list == NULL || thread == NULL || content == NULL) {
+        LOG_ERROR("list, thread or content is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    list_status status = LIST_OK;
+    for (;;) {
+        _Atomic(uintptr_t)* prev;
+        lf_sll* cur;
+        uintptr_t next;
+        if (!lf_sll_find(list, thread, content, &prev, &cur, &next)) {
+            status = LIST_ERR_NOT_FOUND;
+            break;
+        }
+        // the mark decides which thread removed the node.
+        if (!atomic_compare_exchange_strong(&cur->next_ptr, &next, next | LF_SLL_MARK)) {
+            continue;
+        }
+        atomic_fetch_sub_explicit(&list->count, 1, memory_order_relaxed);
+
+        uintptr_t expected = (uintptr_t)cur;
+        if (atomic_compare_exchange_strong(prev, &expected, next)) {
+            hp_retire(list->domain, thread, cur, lf_sll_reclaim);
+        } else {
+            // someone changed prev, let a find unlink the node.
+            lf_sll_find(list, thread, content, &prev, &cur, &next);
+        }
+        break;
+    }
+    hp_clear(thread);
+    return status;
+}
+
+/**
+ * @brief the number of contents in the set. Exact only when no thread
+ * is changing the list.
+ *
+ * @param list
+ * @return size_t
+ */
+size_t lf_sll_count(lf_sll_list* list) {
+    return list != NULL ? atomic_load(&list->count) : 0;
+}
+
+/**
+ * @brief printing the list.
+ *
+ * @cond no thread may change the list meanwhile.
+ *
+ * @param list
+ */
+void lf_sll_print(lf_sll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return;
+    }
+    printf("*** list:\n");
+    int i = 1;
+    for (lf_sll* cur = lf_sll_ptr(atomic_load(&list->head)); cur != NULL;
+            cur = lf_sll_ptr(atomic_load(&cur->next_ptr))) {
+        printf("%d. %s\n", i++, cur->content->text);
+    }
+    printf("*** size=%zu\n", lf_sll_count(list));
+}
+
+/**
+ * @brief freeing the list with all its nodes, including the retired
+ * ones. return NULL when complete.
+ *
+ * @cond no thread may use the list any more.
+ *
+ * @param list
+ * @return lf_sll_list*
+ */
+lf_sll_list* lf_sll_free(lf_sll_list* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+    lf_sll* cur = lf_sll_ptr(atomic_load(&list->head));
+    while (cur != NULL) {
+        lf_sll* next = lf_sll_ptr(atomic_load(&cur->next_ptr));
+        free(cur);
+        cur = next;
+    }
+    hp_domain_free(list->domain);
+    free(list);
+    return NULL;
+}
+
+/**
+ * @brief Testing code starts here ...
+ * Define LF_SLL_NO_MAIN to use the functions above from another program.
+ *
+ */
+#ifndef LF_SLL_NO_MAIN
+
+#define TEST_THREADS 4
+#define TEST_KEYS 64
+#define TEST_OPS 200000
+
+/**
+ * @brief checking that the list is sorted, without duplicates and
+ * without marked nodes, and that the count matches.
+ *
+ */
+void test_check_list(lf_sll_list* list) {
+    size_t count = 0;
+    lf_sll* prev = NULL;
+    for (lf_sll* cur = lf_sll_ptr(atomic_load(&list->head)); cur != NULL;
+            cur = lf_sll_ptr(atomic_load(&cur->next_ptr))) {
+        assert(!lf_sll_is_marked(atomic_load(&cur->next_ptr)));
+        assert(prev == NULL || content_compare(prev->content, cur->content) < 0);
+        prev = cur;
+        count++;
+    }
+    assert(count == lf_sll_count(list));
+}
+
+void test_single_thread() {
+    printf(">>> 1. one thread <<<\n\n");
+    lf_sll_list* list = lf_sll_make();
+    hp_thread* thread = lf_sll_enter(list);
+
+    list_status status = lf_sll_insert(list, thread, "*** 2.0 ***");
+    assert(status == LIST_OK);
+    status = lf_sll_insert(list, thread, "*** 3.0 ***");
+    assert(status == LIST_OK);
+    status = lf_sll_insert(list, thread, "*** 1.0 ***");
+    assert(status == LIST_OK);
+    status = lf_sll_insert(list, thread, "*** 2.0 ***");
+    assert(status == LIST_ERR_EXISTS);
+    status = lf_sll_insert(list, NULL, "*** 2.0 ***");
+    assert(status == LIST_ERR_NULL);
+    assert(lf_sll_count(list) == 3);
+    lf_sll_print(list);
+    test_check_list(list);
+
+    my_content* search_content = content_make("*** 2.0 ***");
+    assert(lf_sll_contains(list, thread, search_content));
+    status = lf_sll_remove(list, thread, search_content);
+    assert(status == LIST_OK);
+    assert(!lf_sll_contains(list, thread, search_content));
+    status = lf_sll_remove(list, thread, search_content);
+    assert(status == LIST_ERR_NOT_FOUND);
+    content_free(search_content);
+
+    // removing the first and the last node.
+    search_content = content_make("*** 1.0 ***");
+    status = lf_sll_remove(list, thread, search_content);
+    assert(status == LIST_OK);
+    content_free(search_content);
+    search_content = content_make("*** 3.0 ***");
+    status = lf_sll_remove(list, thread, search_content);
+    assert(status == LIST_OK);
+    content_free(search_content);
+    assert(lf_sll_count(list) == 0);
+    assert(atomic_load(&list->head) == 0);
+    lf_sll_print(list);
+
+    lf_sll_leave(list, thread);
+    list = lf_sll_free(list);
+}
+
+typedef struct test_worker {
+    lf_sll_list* list;
+    my_content** keys;
+    unsigned int seed;
+    long net[TEST_KEYS];     // successful inserts minus removes per key
+} test_worker;
+
+void* test_stress_worker(void* arg) {
+    test_worker* worker = arg;
+    hp_thread* thread = lf_sll_enter(worker->list);
+    unsigned long long seed = worker->seed;
+    for (int i = 0; i < TEST_OPS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t key = seed % TEST_KEYS;
+        my_content* content = worker->keys[key];
+        switch ((seed >> 32) % 3) {
+        case 0:
+            if (lf_sll_insert(worker->list, thread, content->text) == LIST_OK) {
+                worker->net[key]++;
+            }
+            break;
+        case 1:
+            if (lf_sll_remove(worker->list, thread, content) == LIST_OK) {
+                worker->net[key]--;
+            }
+            break;
+        default:
+            lf_sll_contains(worker->list, thread, content);
+            break;
+        }
+    }
+    lf_sll_leave(worker->list, thread);
+    return NULL;
+}
+
+/**
+ * @brief several threads insert, search and remove the same few keys.
+ * Afterwards every key must be in the list exactly when it was inserted
+ * once more than it was removed.
+ *
+ */
+void test_stress() {
+    printf(">>> 2. %d threads, %d ops each on %d keys <<<\n\n", TEST_THREADS, TEST_OPS, TEST_KEYS);
+    lf_sll_list* list = lf_sll_make();
+    my_content* keys[TEST_KEYS];
+    char buf[32];
+    for (int i = 0; i < TEST_KEYS; i++) {
+        snprintf(buf, sizeof(buf), "key-%03d", i);
+        keys[i] = content_make(buf);
+    }
+
+    pthread_t threads[TEST_THREADS];
+    test_worker workers[TEST_THREADS];
+    for (int t = 0; t < TEST_THREADS; t++) {
+        workers[t].list = list;
+        workers[t].keys = keys;
+        workers[t].seed = 2463534242u + t * 7919;
+        memset(workers[t].net, 0, sizeof(workers[t].net));
+        pthread_create(&threads[t], NULL, test_stress_worker, &workers[t]);
+    }
+    for (int t = 0; t < TEST_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    test_check_list(list);
+    hp_thread* thread = lf_sll_enter(list);
+    size_t present = 0;
+    for (int i = 0; i < TEST_KEYS; i++) {
+        long net = 0;
+        for (int t = 0; t < TEST_THREADS; t++) {
+            net += workers[t].net[i];
+        }
+        assert(net == 0 || net == 1);
+        assert(lf_sll_contains(list, thread, keys[i]) == (net == 1));
+        present += net;
+        keys[i] = content_free(keys[i]);
+    }
+    lf_sll_leave(list, thread);
+    assert(lf_sll_count(list) == present);
+    printf("keys left= %zu\n", present);
+    list = lf_sll_free(list);
+}
+
+/**
+ * @brief main program does these:
+ * 1. insert, search and remove from one thread.
+ * 2. stress the list from several threads.
+ *
+ * @param argv
+ * @return int
+ */
+int main(int argc, char* argv[]) {
+    test_single_thread();
+    test_stress();
+    return 0;
+}
+#endif
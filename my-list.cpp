@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include "my_list.hpp"
+// last: its `reset` macro would clash with std:: members.
+#include "ansi_color_codes.h"
+
+using namespace std;
+
+/**
+ * @brief Example of the C++ lists in my_list.hpp, List<T> and DList<T>.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+const string test_str_node_0_5 = "*** Node 0.5 ***";
+const string test_str_node_1_0 = "*** Node 1.0 ***";
+const string test_str_node_1_5 = "*** Node 1.5 ***";
+const string test_str_node_2_0 = "*** Node 2.0 ***";
+const string test_str_node_3_0 = "*** Node 3.0 ***";
+
+/**
+ * @brief a std::allocator that counts the nodes it hands out.
+ *
+ */
+static size_t test_live_allocations = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        test_live_allocations += n;
+        return allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        test_live_allocations -= n;
+        allocator<T>().deallocate(p, n);
+    }
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+/**
+ * @brief a value that counts its copies, to check the lists never copy.
+ *
+ */
+struct Tracked {
+    static inline int copies = 0;
+    string text;
+
+    explicit Tracked(string text) : text(move(text)) {}
+    Tracked(const Tracked& other) : text(other.text) { copies++; }
+    Tracked(Tracked&&) = default;
+};
+
+template <typename ListType>
+void test_print(const ListType& list) {
+    int i = 1;
+    for (const string& text : list) {
+        cout << i++ << ". " << text << endl;
+    }
+    cout << ">>> list size: " << list.size() << endl;
+}
+
+void test_list() {
+    printf("%s\ntest_list%s\n", GRN, reset);
+    List<string> list;
+    assert(list.empty());
+    list.emplace_back(test_str_node_1_0);
+    list.emplace_back(test_str_node_3_0);
+    list.emplace_front(test_str_node_0_5);
+    assert(list.size() == 3);
+    assert(list.front() == test_str_node_0_5 && list.back() == test_str_node_3_0);
+    test_print(list);
+
+    printf("*** searching with std::find\n");
+    auto at = find(list.begin(), list.end(), test_str_node_1_0);
+    assert(at != list.end() && *at == test_str_node_1_0);
+    assert(find(list.cbegin(), list.cend(), test_str_node_1_5) == list.cend());
+
+    printf("*** inserting after a node\n");
+    auto inserted = list.emplace_after(at, test_str_node_2_0);
+    assert(*inserted == test_str_node_2_0 && list.size() == 4);
+    list.emplace_after(inserted, "*** Node 2.5 ***");
+    test_print(list);
+
+    printf("*** removing after a node\n");
+    auto next = list.erase_after(inserted);
+    assert(*next == test_str_node_3_0);
+    next = list.erase_after(inserted);
+    assert(next == list.end() && list.back() == test_str_node_2_0);
+    list.pop_front();
+    assert(list.front() == test_str_node_1_0 && list.size() == 2);
+    test_print(list);
+
+    printf("*** moving a list\n");
+    List<string> moved = move(list);
+    assert(list.empty() && list.size() == 0);
+    assert(moved.size() == 2);
+    list = move(moved);
+    assert(list.size() == 2 && moved.empty());
+
+    List<string> copy(list.begin(), list.end());
+    assert(equal(copy.begin(), copy.end(), list.begin()));
+}
+
+void test_dlist() {
+    printf("%s\ntest_dlist%s\n", GRN, reset);
+    DList<string> list;
+    list.emplace_back(test_str_node_1_0);
+    list.emplace_back(test_str_node_3_0);
+    list.emplace_front(test_str_node_0_5);
+    test_print(list);
+
+    printf("*** iterating backward\n");
+    assert(*list.rbegin() == test_str_node_3_0);
+    assert(*prev(list.end()) == test_str_node_3_0);
+    for (auto cur = list.rbegin(); cur != list.rend(); ++cur) {
+        cout << *cur << endl;
+    }
+
+    printf("*** inserting before a node\n");
+    auto at = find_if(list.begin(), list.end(), [](const string& text) { return text == test_str_node_3_0; });
+    auto inserted = list.emplace(at, test_str_node_2_0);
+    assert(*inserted == test_str_node_2_0 && *next(inserted) == test_str_node_3_0);
+    list.emplace(list.end(), "*** Node 4.0 ***");
+    assert(list.back() == "*** Node 4.0 ***" && list.size() == 5);
+    test_print(list);
+
+    printf("*** removing nodes\n");
+    auto after = list.erase(inserted);
+    assert(*after == test_str_node_3_0);
+    list.pop_back();
+    list.pop_front();
+    assert(list.front() == test_str_node_1_0 && list.back() == test_str_node_3_0);
+    assert(list.size() == 2);
+    list.erase(list.begin());
+    list.erase(list.begin());
+    assert(list.empty() && list.begin() == list.end());
+}
+
+void test_node_transfer() {
+    printf("%s\ntest_node_transfer%s\n", GRN, reset);
+    Tracked::copies = 0;
+    DList<Tracked> from;
+    List<Tracked> to;
+    from.emplace_back(test_str_node_1_0);
+    from.emplace_back(test_str_node_2_0);
+    from.emplace_back(test_str_node_3_0);
+    const Tracked* address = &from.back();
+
+    printf("*** nodes move between lists of the same kind\n");
+    DList<Tracked> other;
+    other.push_front(from.extract(prev(from.end())));
+    assert(&other.front() == address && from.size() == 2);
+
+    auto handle = from.extract(from.begin());
+    assert(handle && handle.value().text == test_str_node_1_0);
+    from.insert(from.end(), move(handle));
+    assert(handle.empty());
+    assert(from.back().text == test_str_node_1_0 && from.front().text == test_str_node_2_0);
+
+    printf("*** a node that is never inserted is freed by its handle\n");
+    List<Tracked> list;
+    list.emplace_back(test_str_node_0_5);
+    list.emplace_back(test_str_node_1_5);
+    {
+        auto dropped = list.extract_front();
+        assert(dropped.value().text == test_str_node_0_5);
+    }
+    list.push_back(list.extract_front());
+    to = move(list);
+    assert(to.size() == 1 && to.front().text == test_str_node_1_5);
+
+    // moving values in works as well, nothing was copied.
+    to.push_back(Tracked(test_str_node_2_0));
+    assert(Tracked::copies == 0);
+}
+
+void test_allocator() {
+    printf("%s\ntest_allocator%s\n", GRN, reset);
+    {
+        List<int, CountingAllocator<int>> list;
+        DList<int, CountingAllocator<int>> dlist;
+        for (int i = 0; i < 10; i++) {
+            list.push_back(i);
+            dlist.push_front(i);
+        }
+        assert(test_live_allocations == 20);
+        list.pop_front();
+        dlist.pop_back();
+        assert(test_live_allocations == 18);
+        assert(list.front() == 1 && dlist.back() == 1);
+
+        auto handle = dlist.extract(dlist.begin());
+        assert(test_live_allocations == 18);
+    }
+    assert(test_live_allocations == 0);
+}
+
+/**
+ * @brief running test code for the C++ lists.
+ *
+ */
+int main() {
+    printf("%s---> STARTS!%s\n", RED, reset);
+    test_list();
+    test_dlist();
+    test_node_transfer();
+    test_allocator();
+    printf("%s\n---> ENDS!%s\n", RED, reset);
+    return 0;
+}
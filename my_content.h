@@ -0,0 +1,172 @@
+#ifndef MY_CONTENT_H
+#define MY_CONTENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "list_log.h"
+#include "list_stats.h"
+
+/**
+ * @brief The content of a list node, shared by the singly and the
+ * doubly linked-list.
+ * The length and the text live in one allocation: the text follows
+ * the length directly (flexible array member), so reading the text of
+ * a content is one pointer hop and making a content is one malloc.
+ *
+ * Every content also carries a 64-bit hash of its text, computed once
+ * when it is made. Comparing two contents looks at the lengths and the
+ * hashes first and only reads the texts when both match.
+ *
+ */
+typedef struct my_content {
+    size_t length;
+    uint64_t hash;
+    char text[];
+} my_content;
+
+/**
+ * @brief number of bytes needed for a content with a text of the
+ * given length, including the terminating '\0'.
+ *
+ */
+#define CONTENT_SIZE(length) (offsetof(my_content, text) + (length) + 1)
+
+#define CONTENT_HASH_SEED 0x9e3779b97f4a7c15ULL
+
+/**
+ * @brief 64-bit hash of a text, 8 bytes per step: every word is mixed
+ * in with a multiply and the result is finished like MurmurHash3's
+ * fmix64, so all bits of the text reach all bits of the hash.
+ *
+ * @param text
+ * @param length
+ * @return uint64_t
+ */
+static inline uint64_t content_hash(const char* text, size_t length) {
+    uint64_t hash = CONTENT_HASH_SEED ^ (length * 0xff51afd7ed558ccdULL);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, text + i, 8);
+        hash = (hash ^ word) * 0x87c37b91114253d5ULL;
+        hash ^= hash >> 31;
+    }
+    if (i < length) {
+        uint64_t word = 0;
+        memcpy(&word, text + i, length - i);
+        hash = (hash ^ word) * 0x87c37b91114253d5ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * @brief writing a content into memory provided by the caller, for
+ * example right behind a list node.
+ *
+ * @cond memory must hold CONTENT_SIZE(length) bytes.
+ *
+ * @param memory
+ * @param text
+ * @param length
+ * @return my_content*
+ */
+static inline my_content* content_init(void* memory, const char* text, size_t length) {
+    my_content* content = memory;
+    content->length = length;
+    content->hash = content_hash(text, length);
+    memcpy(content->text, text, length);
+    content->text[length] = '\0';
+    return content;
+}
+
+/**
+ * @brief making the content with a given text.
+ *
+ * @cond text cannot be NULL
+ *
+ * @param text
+ * @return my_content*
+ */
+static inline my_content* content_make(const char* text) {
+    if (text == NULL) {
+        LOG_ERROR("text is NULL!\n");
+        return NULL;
+    }
+
+    size_t length = strlen(text);
+    LIST_STATS_ADD(content_allocs, 1);
+    LIST_STATS_ADD(content_bytes, CONTENT_SIZE(length));
+    return content_init(malloc(CONTENT_SIZE(length)), text, length);
+}
+
+/**
+ * @brief Free the content
+ *
+ * @param content
+ * @return my_content*
+ */
+static inline my_content* content_free(my_content* content) {
+    if (content == NULL) {
+        LOG_ERROR("content is NULL!\n");
+        return content;
+    }
+
+    LOG_DEBUG("freeing content node ...\n");
+    LIST_STATS_ADD(content_frees, 1);
+    free(content);
+    return NULL;
+}
+
+/**
+ * @brief Compare if two contents are the same. Contents of different
+ * lengths or hashes are rejected without looking at the text.
+ *
+ * @param c1
+ * @param c2
+ * @return true
+ * @return false
+ */
+static inline bool content_equals(const my_content* c1, const my_content* c2) {
+    if (c1 == NULL || c2 == NULL) {
+        return false;
+    }
+
+    return c1->length == c2->length && c1->hash == c2->hash &&
+        !memcmp(c1->text, c2->text, c1->length);
+}
+
+/**
+ * @brief Ordering of two contents, by text and then by length (a text
+ * comes before the longer texts it is a prefix of).
+ *
+ * @param c1
+ * @param c2
+ * @return int less than, equal to or greater than 0.
+ */
+static inline int content_compare(const my_content* c1, const my_content* c2) {
+    size_t length = c1->length < c2->length ? c1->length : c2->length;
+    int result = memcmp(c1->text, c2->text, length);
+    if (result != 0) {
+        return result;
+    }
+    return (c1->length > c2->length) - (c1->length < c2->length);
+}
+
+/**
+ * @brief A comparator for sorting and merging lists, returning less
+ * than, equal to or greater than 0 like strcmp. NULL stands for
+ * content_compare.
+ *
+ */
+typedef int (*content_compare_fn)(const my_content* c1, const my_content* c2);
+
+#endif
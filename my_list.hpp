@@ -0,0 +1,598 @@
+#ifndef MY_LIST_HPP
+#define MY_LIST_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief [[no_unique_address]] is C++20: an empty allocator then takes
+ * no room in the list handle. Older standards get a plain member.
+ *
+ */
+#if defined(__has_cpp_attribute) && __cplusplus >= 202002L
+#if __has_cpp_attribute(no_unique_address)
+#define MY_LIST_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+#endif
+#ifndef MY_LIST_NO_UNIQUE_ADDRESS
+#define MY_LIST_NO_UNIQUE_ADDRESS
+#endif
+
+/**
+ * @brief C++ versions of my_sll and my_dll: List<T> is the singly
+ * linked-list, DList<T> the doubly linked-list.
+ *
+ * Like the C lists, the handle keeps the first and the last node and
+ * the count, so push_back, back and size are constant time. The value
+ * lives inside the node (as the text of a text node does), it is built
+ * in place by emplace_* and never copied by the list itself.
+ *
+ * - RAII: the destructor frees every node. Lists can be moved but not
+ *   copied, so a deep copy never happens by accident.
+ * - Nodes move between lists without touching the value: extract_*
+ *   hands out a move-only node_handle and push_* / insert take it back.
+ * - The iterators are STL iterators (forward for List, bidirectional
+ *   for DList), so <algorithm> works on the lists.
+ * - Nodes come from Allocator, rebound to the node type.
+ *
+ * There are no virtual functions; everything is inlined like the
+ * static inline helpers of the C headers.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+/**
+ * @brief The allocation part shared by List and DList: making and
+ * freeing nodes through the allocator, and the move-only handle that
+ * owns a node outside of any list.
+ *
+ */
+template <typename Node, typename Allocator>
+class ListNodes {
+public:
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+    class node_handle {
+    public:
+        node_handle() = default;
+        node_handle(node_handle&& other) noexcept
+            : node(std::exchange(other.node, nullptr)), allocator(std::move(other.allocator)) {}
+        node_handle& operator=(node_handle&& other) noexcept {
+            if (this != &other) {
+                drop();
+                node = std::exchange(other.node, nullptr);
+                allocator = std::move(other.allocator);
+            }
+            return *this;
+        }
+        node_handle(const node_handle&) = delete;
+        node_handle& operator=(const node_handle&) = delete;
+        ~node_handle() { drop(); }
+
+        bool empty() const noexcept { return node == nullptr; }
+        explicit operator bool() const noexcept { return node != nullptr; }
+        auto& value() const noexcept { return node->value; }
+
+    private:
+        template <typename, typename> friend class List;
+        template <typename, typename> friend class DList;
+
+        node_handle(Node* node, const node_allocator& allocator) : node(node), allocator(allocator) {}
+
+        Node* release() noexcept { return std::exchange(node, nullptr); }
+
+        void drop() noexcept {
+            if (node != nullptr) {
+                free_node(allocator, std::exchange(node, nullptr));
+            }
+        }
+
+        Node* node = nullptr;
+        node_allocator allocator;
+    };
+
+    /**
+     * @brief allocating a node and building its value in place. The
+     * links are left for the list to set.
+     *
+     */
+    template <typename... Args>
+    static Node* make_node(node_allocator& allocator, Args&&... args) {
+        Node* node = node_traits::allocate(allocator, 1);
+        try {
+            node_traits::construct(allocator, std::addressof(node->value), std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(allocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    static void free_node(node_allocator& allocator, Node* node) noexcept {
+        node_traits::destroy(allocator, std::addressof(node->value));
+        node_traits::deallocate(allocator, node, 1);
+    }
+};
+
+/**
+ * @brief The singly linked-list, see my_sll.
+ *
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class List {
+    struct Node {
+        Node* next_ptr;
+        T value;
+    };
+    using nodes = ListNodes<Node, Allocator>;
+    using node_allocator = typename nodes::node_allocator;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using node_handle = typename nodes::node_handle;
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() = default;
+        operator basic_iterator<true>() const noexcept { return basic_iterator<true>(node); }
+
+        reference operator*() const noexcept { return node->value; }
+        pointer operator->() const noexcept { return std::addressof(node->value); }
+        basic_iterator& operator++() noexcept {
+            node = node->next_ptr;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            basic_iterator previous = *this;
+            node = node->next_ptr;
+            return previous;
+        }
+        friend bool operator==(basic_iterator a, basic_iterator b) noexcept { return a.node == b.node; }
+        friend bool operator!=(basic_iterator a, basic_iterator b) noexcept { return a.node != b.node; }
+
+    private:
+        friend class List;
+        template <bool> friend class basic_iterator;
+        explicit basic_iterator(Node* node) noexcept : node(node) {}
+        Node* node = nullptr;
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    List() noexcept(noexcept(Allocator())) : List(Allocator()) {}
+    explicit List(const Allocator& allocator) noexcept : allocator(allocator) {}
+
+    template <typename InputIt>
+    List(InputIt first, InputIt last, const Allocator& allocator = Allocator()) : List(allocator) {
+        try {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    List(List&& other) noexcept
+        : head(std::exchange(other.head, nullptr)), tail(std::exchange(other.tail, nullptr)),
+          count(std::exchange(other.count, 0)), allocator(std::move(other.allocator)) {}
+
+    List& operator=(List&& other) noexcept {
+        if (this != &other) {
+            clear();
+            head = std::exchange(other.head, nullptr);
+            tail = std::exchange(other.tail, nullptr);
+            count = std::exchange(other.count, 0);
+            allocator = std::move(other.allocator);
+        }
+        return *this;
+    }
+
+    List(const List&) = delete;
+    List& operator=(const List&) = delete;
+
+    ~List() { clear(); }
+
+    iterator begin() noexcept { return iterator(head); }
+    iterator end() noexcept { return iterator(); }
+    const_iterator begin() const noexcept { return const_iterator(head); }
+    const_iterator end() const noexcept { return const_iterator(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return head == nullptr; }
+    size_type size() const noexcept { return count; }
+    allocator_type get_allocator() const noexcept { return allocator_type(allocator); }
+
+    reference front() noexcept { return head->value; }
+    const_reference front() const noexcept { return head->value; }
+    reference back() noexcept { return tail->value; }
+    const_reference back() const noexcept { return tail->value; }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        return link_back(nodes::make_node(allocator, std::forward<Args>(args)...))->value;
+    }
+
+    template <typename... Args>
+    reference emplace_front(Args&&... args) {
+        return link_front(nodes::make_node(allocator, std::forward<Args>(args)...))->value;
+    }
+
+    /**
+     * @brief building a value right after `at`, which must be a node of
+     * this list (a singly linked-list cannot reach the node before).
+     *
+     */
+    template <typename... Args>
+    iterator emplace_after(const_iterator at, Args&&... args) {
+        return link_after(at.node, nodes::make_node(allocator, std::forward<Args>(args)...));
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void push_front(const T& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    void push_back(node_handle&& handle) { link_back(take(std::move(handle))); }
+    void push_front(node_handle&& handle) { link_front(take(std::move(handle))); }
+    iterator insert_after(const_iterator at, node_handle&& handle) {
+        return link_after(at.node, take(std::move(handle)));
+    }
+
+    /**
+     * @brief unlinking the first node. The value stays in the node,
+     * which can go into another list with push_* / insert_after.
+     *
+     */
+    node_handle extract_front() noexcept {
+        assert(head != nullptr);
+        Node* node = head;
+        head = node->next_ptr;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+        count--;
+        return node_handle(node, allocator);
+    }
+
+    /**
+     * @brief unlinking the node after `at`.
+     *
+     */
+    node_handle extract_after(const_iterator at) noexcept {
+        Node* before = at.node;
+        Node* node = before->next_ptr;
+        assert(node != nullptr);
+        before->next_ptr = node->next_ptr;
+        if (tail == node) {
+            tail = before;
+        }
+        count--;
+        return node_handle(node, allocator);
+    }
+
+    void pop_front() noexcept { extract_front(); }
+
+    /**
+     * @brief removing the node after `at`. Returns the node that
+     * followed the removed one.
+     *
+     */
+    iterator erase_after(const_iterator at) noexcept {
+        extract_after(at);
+        return iterator(at.node->next_ptr);
+    }
+
+    void clear() noexcept {
+        Node* cur = head;
+        while (cur != nullptr) {
+            Node* next = cur->next_ptr;
+            nodes::free_node(allocator, cur);
+            cur = next;
+        }
+        head = nullptr;
+        tail = nullptr;
+        count = 0;
+    }
+
+private:
+    Node* take(node_handle&& handle) noexcept {
+        assert(!handle.empty());
+        return handle.release();
+    }
+
+    Node* link_back(Node* node) noexcept {
+        node->next_ptr = nullptr;
+        if (tail == nullptr) {
+            head = node;
+        } else {
+            tail->next_ptr = node;
+        }
+        tail = node;
+        count++;
+        return node;
+    }
+
+    Node* link_front(Node* node) noexcept {
+        node->next_ptr = head;
+        head = node;
+        if (tail == nullptr) {
+            tail = node;
+        }
+        count++;
+        return node;
+    }
+
+    iterator link_after(Node* before, Node* node) noexcept {
+        node->next_ptr = before->next_ptr;
+        before->next_ptr = node;
+        if (tail == before) {
+            tail = node;
+        }
+        count++;
+        return iterator(node);
+    }
+
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    size_type count = 0;
+    MY_LIST_NO_UNIQUE_ADDRESS node_allocator allocator;
+};
+
+/**
+ * @brief The doubly linked-list, see my_dll.
+ *
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class DList {
+    struct Node {
+        Node* prev_ptr;
+        Node* next_ptr;
+        T value;
+    };
+    using nodes = ListNodes<Node, Allocator>;
+    using node_allocator = typename nodes::node_allocator;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using node_handle = typename nodes::node_handle;
+
+    /**
+     * @brief The end iterator has no node; it keeps the list so that
+     * stepping back from it lands on the tail.
+     *
+     */
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() = default;
+        operator basic_iterator<true>() const noexcept { return basic_iterator<true>(node, list); }
+
+        reference operator*() const noexcept { return node->value; }
+        pointer operator->() const noexcept { return std::addressof(node->value); }
+        basic_iterator& operator++() noexcept {
+            node = node->next_ptr;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            basic_iterator previous = *this;
+            node = node->next_ptr;
+            return previous;
+        }
+        basic_iterator& operator--() noexcept {
+            node = node == nullptr ? list->tail : node->prev_ptr;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            basic_iterator next = *this;
+            --*this;
+            return next;
+        }
+        friend bool operator==(basic_iterator a, basic_iterator b) noexcept { return a.node == b.node; }
+        friend bool operator!=(basic_iterator a, basic_iterator b) noexcept { return a.node != b.node; }
+
+    private:
+        friend class DList;
+        template <bool> friend class basic_iterator;
+        basic_iterator(Node* node, const DList* list) noexcept : node(node), list(list) {}
+        Node* node = nullptr;
+        const DList* list = nullptr;
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    DList() noexcept(noexcept(Allocator())) : DList(Allocator()) {}
+    explicit DList(const Allocator& allocator) noexcept : allocator(allocator) {}
+
+    template <typename InputIt>
+    DList(InputIt first, InputIt last, const Allocator& allocator = Allocator()) : DList(allocator) {
+        try {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    DList(DList&& other) noexcept
+        : head(std::exchange(other.head, nullptr)), tail(std::exchange(other.tail, nullptr)),
+          count(std::exchange(other.count, 0)), allocator(std::move(other.allocator)) {}
+
+    DList& operator=(DList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            head = std::exchange(other.head, nullptr);
+            tail = std::exchange(other.tail, nullptr);
+            count = std::exchange(other.count, 0);
+            allocator = std::move(other.allocator);
+        }
+        return *this;
+    }
+
+    DList(const DList&) = delete;
+    DList& operator=(const DList&) = delete;
+
+    ~DList() { clear(); }
+
+    iterator begin() noexcept { return iterator(head, this); }
+    iterator end() noexcept { return iterator(nullptr, this); }
+    const_iterator begin() const noexcept { return const_iterator(head, this); }
+    const_iterator end() const noexcept { return const_iterator(nullptr, this); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    bool empty() const noexcept { return head == nullptr; }
+    size_type size() const noexcept { return count; }
+    allocator_type get_allocator() const noexcept { return allocator_type(allocator); }
+
+    reference front() noexcept { return head->value; }
+    const_reference front() const noexcept { return head->value; }
+    reference back() noexcept { return tail->value; }
+    const_reference back() const noexcept { return tail->value; }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        return *link_before(nullptr, nodes::make_node(allocator, std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    reference emplace_front(Args&&... args) {
+        return *link_before(head, nodes::make_node(allocator, std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief building a value in front of `at`, end() appends.
+     *
+     */
+    template <typename... Args>
+    iterator emplace(const_iterator at, Args&&... args) {
+        return link_before(at.node, nodes::make_node(allocator, std::forward<Args>(args)...));
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void push_front(const T& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    void push_back(node_handle&& handle) { link_before(nullptr, take(std::move(handle))); }
+    void push_front(node_handle&& handle) { link_before(head, take(std::move(handle))); }
+    iterator insert(const_iterator at, node_handle&& handle) {
+        return link_before(at.node, take(std::move(handle)));
+    }
+
+    /**
+     * @brief unlinking the node at `at`. The value stays in the node,
+     * which can go into another list with push_* / insert.
+     *
+     */
+    node_handle extract(const_iterator at) noexcept {
+        Node* node = at.node;
+        assert(node != nullptr);
+        if (node->prev_ptr == nullptr) {
+            head = node->next_ptr;
+        } else {
+            node->prev_ptr->next_ptr = node->next_ptr;
+        }
+        if (node->next_ptr == nullptr) {
+            tail = node->prev_ptr;
+        } else {
+            node->next_ptr->prev_ptr = node->prev_ptr;
+        }
+        count--;
+        return node_handle(node, allocator);
+    }
+
+    /**
+     * @brief removing the node at `at`. Returns the node that followed.
+     *
+     */
+    iterator erase(const_iterator at) noexcept {
+        iterator next(at.node->next_ptr, this);
+        extract(at);
+        return next;
+    }
+
+    void pop_front() noexcept { extract(begin()); }
+    void pop_back() noexcept { extract(const_iterator(tail, this)); }
+
+    void clear() noexcept {
+        Node* cur = head;
+        while (cur != nullptr) {
+            Node* next = cur->next_ptr;
+            nodes::free_node(allocator, cur);
+            cur = next;
+        }
+        head = nullptr;
+        tail = nullptr;
+        count = 0;
+    }
+
+private:
+    Node* take(node_handle&& handle) noexcept {
+        assert(!handle.empty());
+        return handle.release();
+    }
+
+    iterator link_before(Node* at, Node* node) noexcept {
+        node->next_ptr = at;
+        node->prev_ptr = at == nullptr ? tail : at->prev_ptr;
+        if (node->prev_ptr == nullptr) {
+            head = node;
+        } else {
+            node->prev_ptr->next_ptr = node;
+        }
+        if (at == nullptr) {
+            tail = node;
+        } else {
+            at->prev_ptr = node;
+        }
+        count++;
+        return iterator(node, this);
+    }
+
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    size_type count = 0;
+    MY_LIST_NO_UNIQUE_ADDRESS node_allocator allocator;
+};
+
+#endif
@@ -0,0 +1,562 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "list_log.h"
+#include "my_content.h"
+#include "list_writer.h"
+#include "hazard_ptr.h"
+
+/**
+ * @brief Example of a persistent singly linked-list.
+ * The nodes never change once they are linked. Appending, inserting
+ * and removing make a new version of the list that shares the nodes
+ * behind the change with the version before: only the nodes in front
+ * of it are copied. Prepending copies nothing.
+ *
+ * One writer changes the list; any number of readers take a snapshot,
+ * the current version, in O(1) and walk it as long as they like
+ * without a lock, while the writer goes on. A snapshot never changes.
+ *
+ * A snapshot is protected by a hazard pointer of the reader, so taking
+ * one writes nothing that other threads read. A version that was
+ * replaced is retired to the hazard pointer domain of the list and
+ * freed once no reader has it as a snapshot. Nodes count the versions
+ * and nodes that point at them; freeing a version frees the nodes no
+ * other version shares.
+ *
+ * A thread calls psll_enter before working on a list and passes the
+ * record it gets to every operation, psll_leave when it is done.
+ *
+ * Build with -pthread.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+/**
+ * @brief The node carries its content right behind it, like the text
+ * nodes of my_sll.
+ *
+ */
+typedef struct psll_node {
+    atomic_size_t refs;             // versions and nodes pointing here
+    struct psll_node* next_ptr;
+    my_content* content;
+} psll_node;
+
+typedef struct psll_version {
+    psll_node* head;
+    size_t count;
+} psll_version;
+
+typedef struct psll_list {
+    _Atomic(uintptr_t) current;     // psll_version*
+    hp_domain* domain;
+} psll_list;
+
+// hazard slot that holds a reader's snapshot
+#define PSLL_HP_SNAPSHOT 0
+
+static psll_node* psll_node_make(const char* text, size_t length, psll_node* next) {
+    psll_node* node = malloc(sizeof(psll_node) + CONTENT_SIZE(length));
+    if (node == NULL) {
+        return NULL;
+    }
+    atomic_init(&node->refs, 1);
+    node->next_ptr = next;
+    node->content = content_init(node + 1, text, length);
+    return node;
+}
+
+static psll_node* psll_node_retain(psll_node* node) {
+    if (node != NULL) {
+        atomic_fetch_add_explicit(&node->refs, 1, memory_order_relaxed);
+    }
+    return node;
+}
+
+/**
+ * @brief dropping a reference to a node, and freeing the nodes behind
+ * it that nothing points at any more.
+ *
+ */
+static void psll_node_release(psll_node* node) {
+    while (node != NULL && atomic_fetch_sub_explicit(&node->refs, 1, memory_order_acq_rel) == 1) {
+        psll_node* next = node->next_ptr;
+        free(node);
+        node = next;
+    }
+}
+
+static void psll_version_reclaim(void* version) {
+    psll_node_release(((psll_version*)version)->head);
+    free(version);
+}
+
+/**
+ * @brief making the version that has copies of the nodes of `version`
+ * in front of `at`, followed by `rest`. The reference to rest goes to
+ * the new version.
+ *
+ * @return psll_version* NULL when `at` is not in the version (rest is
+ * released) or out of memory.
+ */
+static psll_version* psll_version_with(const psll_version* version, const psll_node* at, psll_node* rest,
+        size_t count) {
+    psll_version* next = malloc(sizeof(psll_version));
+    if (next == NULL) {
+        psll_node_release(rest);
+        return NULL;
+    }
+    next->head = NULL;
+    next->count = count;
+
+    psll_node** link = &next->head;
+    const psll_node* cur = version->head;
+    for (; cur != at && cur != NULL; cur = cur->next_ptr) {
+        psll_node* copy = psll_node_make(cur->content->text, cur->content->length, NULL);
+        if (copy == NULL) {
+            break;
+        }
+        *link = copy;
+        link = &copy->next_ptr;
+    }
+    if (cur != at) {
+        psll_version_reclaim(next);
+        psll_node_release(rest);
+        return NULL;
+    }
+    *link = rest;
+    return next;
+}
+
+/**
+ * @brief making the version current and retiring the one it replaces.
+ *
+ */
+static void psll_publish(psll_list* list, hp_thread* thread, psll_version* version) {
+    uintptr_t old = atomic_exchange(&list->current, (uintptr_t)version);
+    hp_retire(list->domain, thread, (void*)old, psll_version_reclaim);
+}
+
+/**
+ * @brief making an empty list.
+ *
+ * @return psll_list*
+ */
+psll_list* psll_make() {
+    psll_list* list = malloc(sizeof(psll_list));
+    psll_version* version = malloc(sizeof(psll_version));
+    version->head = NULL;
+    version->count = 0;
+    atomic_init(&list->current, (uintptr_t)version);
+    list->domain = hp_domain_make();
+    return list;
+}
+
+/**
+ * @brief taking a thread record for working on the list.
+ *
+ * @param list
+ * @return hp_thread* NULL when HP_MAX_THREADS threads use the list.
+ */
+hp_thread* psll_enter(psll_list* list) {
+    hp_thread* thread = hp_thread_enter(list->domain);
+    if (thread == NULL) {
+        LOG_ERROR("too many threads on the list!\n");
+    }
+    return thread;
+}
+
+/**
+ * @brief giving the thread record back. A snapshot still taken is
+ * released.
+ *
+ */
+void psll_leave(psll_list* list, hp_thread* thread) {
+    hp_thread_leave(list->domain, thread);
+}
+
+/**
+ * @brief taking the current version of the list, which stays as it is
+ * until psll_release (or the next psll_snapshot of the thread).
+ *
+ * @param list
+ * @param thread
+ * @return const psll_version*
+ */
+const psll_version* psll_snapshot(psll_list* list, hp_thread* thread) {
+    if (list == NULL || thread == NULL) {
+        LOG_ERROR("list and/or thread is NULL!\n");
+        return NULL;
+    }
+    return (const psll_version*)hp_protect(thread, PSLL_HP_SNAPSHOT, &list->current);
+}
+
+/**
+ * @brief letting go of the thread's snapshot; it may be freed from now
+ * on.
+ *
+ */
+void psll_release(hp_thread* thread) {
+    if (thread != NULL) {
+        hp_set(thread, PSLL_HP_SNAPSHOT, NULL);
+    }
+}
+
+/**
+ * @brief the current version, for the writer. It stays valid until
+ * the writer changes the list.
+ *
+ * @param list
+ * @return const psll_version*
+ */
+const psll_version* psll_current(psll_list* list) {
+    return (const psll_version*)atomic_load_explicit(&list->current, memory_order_relaxed);
+}
+
+/**
+ * @brief Adding a text at the end of the list. All nodes are copied.
+ *
+ * @cond only one thread changes the list at a time.
+ *
+ * @param list
+ * @param thread
+ * @param text
+ * @return list_status
+ */
+list_status psll_append(psll_list* list, hp_thread* thread, const char* text) {
+    if (list == NULL || thread == NULL || text == NULL) {
+        LOG_ERROR("list, thread or text is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    const psll_version* current = psll_current(list);
+    psll_node* node = psll_node_make(text, strlen(text), NULL);
+    psll_version* next = node != NULL ? psll_version_with(current, NULL, node, current->count + 1) : NULL;
+    if (next == NULL) {
+        return LIST_ERR_NO_MEMORY;
+    }
+    psll_publish(list, thread, next);
+    return LIST_OK;
+}
+
+/**
+ * @brief Adding a text in front of the list, in O(1). All nodes are
+ * shared.
+ *
+ * @cond only one thread changes the list at a time.
+ *
+ * @param list
+ * @param thread
+ * @param text
+ * @return list_status
+ */
+list_status psll_prepend(psll_list* list, hp_thread* thread, const char* text) {
+    if (list == NULL || thread == NULL || text == NULL) {
+        LOG_ERROR("list, thread or text is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    const psll_version* current = psll_current(list);
+    psll_node* node = psll_node_make(text, strlen(text), psll_node_retain(current->head));
+    if (node == NULL) {
+        psll_node_release(current->head);
+        return LIST_ERR_NO_MEMORY;
+    }
+    psll_version* next = psll_version_with(current, current->head, node, current->count + 1);
+    if (next == NULL) {
+        return LIST_ERR_NO_MEMORY;
+    }
+    psll_publish(list, thread, next);
+    return LIST_OK;
+}
+
+/**
+ * @brief Inserting a text in front of `at`. The nodes in front of at
+ * are copied, at and the nodes behind it are shared.
+ *
+ * @cond only one thread changes the list at a time.
+ *
+ * @param list
+ * @param thread
+ * @param at a node of the current version.
+ * @param text
+ * @return list_status LIST_ERR_NOT_FOUND when at is not in the current
+ * version (or out of memory).
+ */
+list_status psll_insert(psll_list* list, hp_thread* thread, const psll_node* at, const char* text) {
+    if (list == NULL || thread == NULL || at == NULL || text == NULL) {
+        LOG_ERROR("list, thread, at or text is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    const psll_version* current = psll_current(list);
+    psll_node* node = psll_node_make(text, strlen(text), psll_node_retain((psll_node*)at));
+    if (node == NULL) {
+        psll_node_release((psll_node*)at);
+        return LIST_ERR_NO_MEMORY;
+    }
+    psll_version* next = psll_version_with(current, at, node, current->count + 1);
+    if (next == NULL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+    psll_publish(list, thread, next);
+    return LIST_OK;
+}
+
+/**
+ * @brief Removing `at` from the list. The nodes in front of at are
+ * copied, the nodes behind it are shared. at itself stays in the
+ * versions that have it.
+ *
+ * @cond only one thread changes the list at a time.
+ *
+ * @param list
+ * @param thread
+ * @param at a node of the current version.
+ * @return list_status LIST_ERR_NOT_FOUND when at is not in the current
+ * version (or out of memory).
+ */
+list_status psll_remove(psll_list* list, hp_thread* thread, const psll_node* at) {
+    if (list == NULL || thread == NULL || at == NULL) {
+        LOG_ERROR("list, thread or at is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    const psll_version* current = psll_current(list);
+    psll_version* next = psll_version_with(current, at, psll_node_retain(at->next_ptr), current->count - 1);
+    if (next == NULL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+    psll_publish(list, thread, next);
+    return LIST_OK;
+}
+
+/**
+ * @brief the number of nodes of a version, in O(1).
+ *
+ * @param version
+ * @return size_t
+ */
+size_t psll_size(const psll_version* version) {
+    return version != NULL ? version->count : 0;
+}
+
+/**
+ * @brief the first node of a version with a given content.
+ *
+ * @param version
+ * @param content
+ * @return const psll_node* NULL when there is none.
+ */
+const psll_node* psll_search(const psll_version* version, const my_content* content) {
+    if (version == NULL || content == NULL) {
+        LOG_ERROR("version and/or content is NULL!\n");
+        return NULL;
+    }
+    for (const psll_node* cur = version->head; cur != NULL; cur = cur->next_ptr) {
+        if (content_equals(cur->content, content)) {
+            return cur;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief write all nodes of a version, in the format of sll_print,
+ * through a buffered writer (list_writer.h).
+ *
+ * @param version
+ * @param writer
+ * @return list_status LIST_ERR_IO when writing failed.
+ */
+list_status psll_write(const psll_version* version, list_writer* writer) {
+    if (writer == NULL) {
+        LOG_ERROR("writer is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (version == NULL || version->head == NULL) {
+        list_writer_string(writer, "list is empty!\n");
+        return writer->failed ? LIST_ERR_IO : LIST_OK;
+    }
+
+    size_t count = 1;
+    list_writer_string(writer, "*** list:\n");
+    for (const psll_node* cur = version->head; cur != NULL; cur = cur->next_ptr) {
+        list_writer_node(writer, count++, cur->content);
+    }
+    list_writer_string(writer, "*** size=");
+    list_writer_number(writer, version->count);
+    list_writer_text(writer, "\n", 1);
+    return writer->failed ? LIST_ERR_IO : LIST_OK;
+}
+
+void psll_print(const psll_version* version) {
+    list_writer writer;
+    list_writer_init_file(&writer, stdout, LIST_COLOR_AUTO);
+    psll_write(version, &writer);
+    list_writer_release(&writer);
+}
+
+/**
+ * @brief freeing the list with all its versions and nodes. return NULL
+ * when complete.
+ *
+ * @cond no thread may use the list any more.
+ *
+ * @param list
+ * @return psll_list*
+ */
+psll_list* psll_free(psll_list* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+    psll_version_reclaim((void*)atomic_load(&list->current));
+    hp_domain_free(list->domain);
+    free(list);
+    return NULL;
+}
+
+/**
+ * @brief Testing code starts here ...
+ * Define PSLL_NO_MAIN to use the functions above from another program.
+ *
+ */
+#ifndef PSLL_NO_MAIN
+
+#define TEST_READERS 3
+#define TEST_WRITES 20000
+#define TEST_WINDOW 32
+
+void test_single_thread() {
+    printf(">>> 1. versions share their nodes <<<\n\n");
+    psll_list* list = psll_make();
+    hp_thread* writer = psll_enter(list);
+    hp_thread* reader = psll_enter(list);
+
+    list_status status = psll_append(list, writer, "*** 2.0 ***");
+    assert(status == LIST_OK);
+    status = psll_append(list, writer, "*** 3.0 ***");
+    assert(status == LIST_OK);
+    status = psll_prepend(list, writer, "*** 1.0 ***");
+    assert(status == LIST_OK);
+    status = psll_append(list, NULL, "*** 4.0 ***");
+    assert(status == LIST_ERR_NULL);
+    const psll_version* before = psll_snapshot(list, reader);
+    assert(psll_size(before) == 3);
+    psll_print(before);
+
+    // the new version copies 1.0 and shares 2.0 and 3.0 with the snapshot.
+    my_content* search_content = content_make("*** 2.0 ***");
+    const psll_node* at = psll_search(psll_current(list), search_content);
+    status = psll_insert(list, writer, at, "*** 1.5 ***");
+    assert(status == LIST_OK);
+    const psll_version* after = psll_current(list);
+    assert(psll_size(after) == 4 && after != before);
+    assert(after->head != before->head && after->head->next_ptr->next_ptr == at);
+    psll_print(after);
+
+    status = psll_remove(list, writer, psll_search(psll_current(list), search_content));
+    assert(status == LIST_OK);
+    assert(psll_search(psll_current(list), search_content) == NULL);
+    status = psll_remove(list, writer, at);
+    assert(status == LIST_ERR_NOT_FOUND);
+    content_free(search_content);
+    psll_print(psll_current(list));
+
+    // the snapshot has not changed.
+    assert(psll_size(before) == 3 && before->head->next_ptr == at);
+    psll_print(before);
+    psll_release(reader);
+
+    psll_leave(list, reader);
+    psll_leave(list, writer);
+    list = psll_free(list);
+}
+
+typedef struct test_reader {
+    psll_list* list;
+    atomic_bool* done;
+    size_t snapshots;
+} test_reader;
+
+/**
+ * @brief taking snapshots while the writer goes on. The writer keeps
+ * the list a run of consecutive keys, which every snapshot must be.
+ *
+ */
+void* test_reader_run(void* arg) {
+    test_reader* reader = arg;
+    hp_thread* thread = psll_enter(reader->list);
+    while (!atomic_load(reader->done)) {
+        const psll_version* version = psll_snapshot(reader->list, thread);
+        size_t count = 0;
+        long prev = -1;
+        for (const psll_node* cur = version->head; cur != NULL; cur = cur->next_ptr) {
+            long key = strtol(cur->content->text + 4, NULL, 10);
+            assert(prev < 0 || key == prev + 1);
+            prev = key;
+            count++;
+        }
+        assert(count == psll_size(version));
+        psll_release(thread);
+        reader->snapshots++;
+    }
+    psll_leave(reader->list, thread);
+    return NULL;
+}
+
+void test_readers() {
+    printf(">>> 2. %d readers while one writer makes %d versions <<<\n\n", TEST_READERS, TEST_WRITES);
+    psll_list* list = psll_make();
+    atomic_bool done = false;
+    pthread_t threads[TEST_READERS];
+    test_reader readers[TEST_READERS];
+    for (int t = 0; t < TEST_READERS; t++) {
+        readers[t] = (test_reader){ list, &done, 0 };
+        pthread_create(&threads[t], NULL, test_reader_run, &readers[t]);
+    }
+
+    hp_thread* writer = psll_enter(list);
+    char text[32];
+    long next_key = 0;
+    list_status status;
+    for (int i = 0; i < TEST_WRITES; i++) {
+        const psll_version* current = psll_current(list);
+        if (psll_size(current) < TEST_WINDOW) {
+            snprintf(text, sizeof(text), "key-%06ld", next_key++);
+            status = psll_append(list, writer, text);
+        } else {
+            status = psll_remove(list, writer, current->head);
+        }
+        assert(status == LIST_OK);
+    }
+    atomic_store(&done, true);
+    for (int t = 0; t < TEST_READERS; t++) {
+        pthread_join(threads[t], NULL);
+        printf("reader %d: %zu snapshots\n", t, readers[t].snapshots);
+    }
+    psll_print(psll_current(list));
+    psll_leave(list, writer);
+    list = psll_free(list);
+}
+
+/**
+ * @brief main program does these:
+ * 1. make versions from one thread and check what they share.
+ * 2. read snapshots from several threads while one thread writes.
+ *
+ * @param argv
+ * @return int
+ */
+int main(int argc, char* argv[]) {
+    test_single_thread();
+    test_readers();
+    return 0;
+}
+#endif
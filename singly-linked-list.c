@@ -1,6 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
+#include "list_pool.h"
+#include "list_arena.h"
+#include "list_log.h"
+#include "my_content.h"
+#include "list_index.h"
+#include "list_file.h"
+#include "list_stream.h"
+#include "list_writer.h"
+#include "list_trace.h"
 
 /**
  * @brief Example of a singly linked-list management.
@@ -16,18 +26,166 @@
 
 /**
  * @brief Data structures for the node and its contents ...
+ * The content (my_content.h) keeps its text inline. A node made with
+ * sll_make_text_node carries its content right behind the node, in
+ * the same allocation.
  * 
  */
-typedef struct my_content{
-    char* text;
-} my_content;
-
-
 typedef struct my_sll {
     struct my_sll *next_ptr;
     my_content *content;
 } my_sll;
 
+/**
+ * @brief The list handle. It keeps track of the first and the last
+ * node so that appending and prepending do not need to walk the list.
+ * 
+ * When pool is set, the nodes of the list come from that pool instead
+ * of malloc. When index is set, searching goes through the hash index
+ * instead of walking the list (see sll_attach_index). When arena is
+ * set, it holds the nodes made by sll_from_array; they are freed all
+ * at once with the arena. When file is set, the contents of the nodes
+ * made by sll_load point into that mapped list file (list_file.h); it
+ * is unmapped together with the arena.
+ * 
+ */
+typedef struct my_sll_list {
+    my_sll *head;
+    my_sll *tail;
+    size_t count;
+    list_pool *pool;
+    list_index *index;
+    list_arena *arena;
+    list_file *file;
+} my_sll_list;
+
+
+/**
+ * @brief making a node with a given content. The node comes from the
+ * pool of the list when it has one.
+ * 
+ * @param list 
+ * @param content 
+ * @return my_sll* 
+ */
+my_sll* sll_make_node(my_sll_list* list, my_content* content) {
+    my_sll* node;
+    if (list != NULL && list->pool != NULL) {
+        node = list_pool_alloc(list->pool);
+        LIST_STATS_ADD(node_bytes, list->pool->node_size);
+    } else {
+        node = malloc(sizeof(my_sll));
+        LIST_STATS_ADD(node_bytes, sizeof(my_sll));
+    }
+    LIST_STATS_ADD(node_allocs, 1);
+    node->next_ptr = NULL;
+    node->content = content;
+    return node;
+}
+
+/**
+ * @brief node size for a pool whose nodes can hold texts of up to
+ * `capacity` characters inline (small-string mode).
+ * 
+ */
+#define SLL_SSO_NODE_SIZE(capacity) (sizeof(my_sll) + CONTENT_SIZE(capacity))
+
+/**
+ * @brief true when the content of the node lives inside the node's
+ * own allocation and must not be freed on its own.
+ * 
+ */
+static inline bool sll_node_embeds_content(my_sll* node) {
+    return node->content == (my_content*)(node + 1);
+}
+
+/**
+ * @brief making a node and its content for a given text. Without a
+ * pool, node and content share one malloc. With a pool, the content
+ * is embedded when the text fits in the pool's node size (see
+ * SLL_SSO_NODE_SIZE), otherwise it gets its own allocation.
+ * 
+ * @cond text cannot be NULL
+ * 
+ * @param list 
+ * @param text 
+ * @return my_sll* 
+ */
+my_sll* sll_make_text_node(my_sll_list* list, const char* text) {
+    if (text == NULL) {
+        LOG_ERROR("text is NULL!\n");
+        return NULL;
+    }
+
+    size_t length = strlen(text);
+    my_sll* node;
+    LIST_STATS_ADD(node_allocs, 1);
+    if (list != NULL && list->pool != NULL) {
+        node = list_pool_alloc(list->pool);
+        LIST_STATS_ADD(node_bytes, list->pool->node_size);
+        if (list->pool->node_size < sizeof(my_sll) + CONTENT_SIZE(length)) {
+            node->content = content_make(text);
+            node->next_ptr = NULL;
+            return node;
+        }
+    } else {
+        node = malloc(sizeof(my_sll) + CONTENT_SIZE(length));
+        LIST_STATS_ADD(node_bytes, sizeof(my_sll) + CONTENT_SIZE(length));
+    }
+    node->content = content_init(node + 1, text, length);
+    node->next_ptr = NULL;
+    return node;
+}
+
+/**
+ * @brief giving the memory of a node back, to the pool of the list
+ * when it has one. The content is not touched. Nodes of the list's
+ * arena stay where they are until the arena is freed.
+ * 
+ * @param list 
+ * @param node 
+ */
+void sll_release_node(my_sll_list* list, my_sll* node) {
+    LIST_STATS_ADD(node_frees, 1);
+    if (list != NULL && list_arena_owns(list->arena, node)) {
+        return;
+    }
+    if (list != NULL && list->pool != NULL) {
+        list_pool_release(list->pool, node);
+    } else {
+        free(node);
+    }
+}
+
+/**
+ * @brief creating a singly linked-list with a given content. The
+ * nodes of the list are allocated from the given pool.
+ * 
+ * @cond content cannot be NULL! pool may be NULL to use malloc.
+ * 
+ * @param pool 
+ * @param content 
+ * @return my_sll_list* 
+ */
+my_sll_list* sll_make_with_pool(list_pool* pool, my_content* content) {
+    if (content == NULL) {
+        LOG_ERROR("content is NULL!\n");
+        return NULL;
+    }
+    if (pool != NULL && pool->node_size < sizeof(my_sll)) {
+        LOG_ERROR("pool nodes are too small!\n");
+        return NULL;
+    }
+    my_sll_list *list = malloc(sizeof(my_sll_list));
+    list->pool = pool;
+    list->index = NULL;
+    list->arena = NULL;
+    list->file = NULL;
+    list->head = sll_make_node(list, content);
+    list->tail = list->head;
+    list->count = 1;
+    return list;
+}
 
 /**
  * @brief creating a singly linked-list with a given content.
@@ -35,297 +193,1545 @@ typedef struct my_sll {
  * @cond content cannot be NULL!
  * 
  * @param content 
- * @return my_sll* 
+ * @return my_sll_list* 
  */
-my_sll* sll_make(my_content* content) {
-    if (content == NULL) {
-        printf("content is NULL!\n");
+my_sll_list* sll_make(my_content* content) {
+    return sll_make_with_pool(NULL, content);
+}
+
+/**
+ * @brief creating a singly linked-list from an array of texts, in one
+ * pass and without walking the list. Every node carries its text
+ * inline, and all nodes come from one contiguous arena owned by the
+ * list, so building costs a couple of mallocs instead of one or two
+ * per text and sll_clear / sll_remove_all release them all at once.
+ * 
+ * Nodes added later come from malloc (or the pool) as usual.
+ * 
+ * @cond texts and every text in it cannot be NULL. count may be 0
+ * for an empty list.
+ * 
+ * @param texts 
+ * @param count 
+ * @return my_sll_list* 
+ */
+my_sll_list* sll_from_array(const char* const* texts, size_t count) {
+    if (texts == NULL && count > 0) {
+        LOG_ERROR("texts is NULL!\n");
         return NULL;
     }
-    my_sll *head = malloc(sizeof(my_sll));
-    head->content = content;
-    head->next_ptr = NULL;
-    return head;
+
+    // first pass over the texts only: the size of the whole batch.
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (texts[i] == NULL) {
+            LOG_ERROR("text %zu is NULL!\n", i);
+            return NULL;
+        }
+        total += list_pool_align(sizeof(my_sll) + CONTENT_SIZE(strlen(texts[i])));
+    }
+
+    my_sll_list *list = malloc(sizeof(my_sll_list));
+    list->pool = NULL;
+    list->index = NULL;
+    list->arena = count > 0 ? list_arena_make(total) : NULL;
+    list->file = NULL;
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = count;
+
+    my_sll** link = &list->head;
+    for (size_t i = 0; i < count; i++) {
+        size_t length = strlen(texts[i]);
+        my_sll* node = list_arena_alloc(list->arena, sizeof(my_sll) + CONTENT_SIZE(length));
+        LIST_STATS_ADD(node_allocs, 1);
+        LIST_STATS_ADD(node_bytes, sizeof(my_sll) + CONTENT_SIZE(length));
+        node->content = content_init(node + 1, texts[i], length);
+        node->next_ptr = NULL;
+        *link = node;
+        link = &node->next_ptr;
+        list->tail = node;
+    }
+    return list;
 }
 
 /**
- * @brief count the number of nodes in the list.
+ * @brief count the number of nodes in the list. The count is kept
+ * up to date by every operation that changes the list, so this does
+ * not walk the nodes.
  * 
- * @param head 
- * @return int 
+ * @param list 
+ * @return size_t 
  */
-int sll_count(my_sll *head) {
+size_t sll_count(my_sll_list *list) {
 
-    if (head == NULL) {
-        printf("head is NULL!\n");
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
         return 0;
     }
 
-    int count = 1;
-    my_sll *cur = head;
-    while (cur->next_ptr != NULL) {
-        count++;
-        cur = cur->next_ptr;
+    return list->count;
+}
+
+/**
+ * @brief append a given node to the end of the list. The tail pointer
+ * makes this a constant time operation.
+ * 
+ * @cond if the list or node is NULL, append fails and returns LIST_ERR_NULL
+ * 
+ * @param list 
+ * @param node 
+ * @return list_status 
+ */
+list_status sll_append_node(my_sll_list* list, my_sll* node) {
+    if (list == NULL || node == NULL) {
+        LOG_ERROR("list or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_APPEND, list->count);
+    node->next_ptr = NULL;
+    if (list->tail == NULL) {
+        list->head = node;
+    } else {
+        list->tail->next_ptr = node;
+    }
+    list->tail = node;
+    list->count++;
+    if (list->index != NULL) {
+        list_index_add(list->index, node, node->content);
     }
-    return count;
+    return LIST_OK;
 }
 
 /**
- * @brief append a node to the end of the list
+ * @brief append a node to the end of the list. The tail pointer
+ * makes this a constant time operation.
  * 
- * @cond if the head is NULL, append fails and returns NULL
+ * @cond if the list is NULL, append fails and returns LIST_ERR_NULL
  * 
- * @param head 
+ * @param list 
  * @param content 
+ * @return list_status 
+ */
+list_status sll_append(my_sll_list* list, my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list or content is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    // make a new node & append to the end.
+    return sll_append_node(list, sll_make_node(list, content));
+}
+
+/**
+ * @brief linking a node in front of the first node, without checks or
+ * tracing, for the operations built on it.
+ * 
+ */
+static void sll_link_front(my_sll_list* list, my_sll* node) {
+    node->next_ptr = list->head;
+    list->head = node;
+    if (list->tail == NULL) {
+        list->tail = node;
+    }
+    list->count++;
+    if (list->index != NULL) {
+        list_index_add(list->index, node, node->content);
+    }
+}
+
+/**
+ * @brief add a given node in front of the first node of the list.
+ * 
+ * @cond if the list or node is NULL, prepend fails and returns LIST_ERR_NULL
+ * 
+ * @param list 
+ * @param node 
+ * @return list_status 
+ */
+list_status sll_prepend_node(my_sll_list* list, my_sll* node) {
+    if (list == NULL || node == NULL) {
+        LOG_ERROR("list or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_INSERT, list->count);
+    sll_link_front(list, node);
+    return LIST_OK;
+}
+
+/**
+ * @brief add a node in front of the first node of the list.
+ * 
+ * @cond if the list is NULL, prepend fails and returns LIST_ERR_NULL
+ * 
+ * @param list 
+ * @param content 
+ * @return list_status 
+ */
+list_status sll_prepend(my_sll_list* list, my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list or content is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    return sll_prepend_node(list, sll_make_node(list, content));
+}
+
+/**
+ * @brief returns the last node of the list.
+ * 
+ * @param list 
  * @return my_sll* 
  */
-my_sll* sll_append(my_sll* head, my_content* content) {
-    if (head == NULL || content == NULL) {
-        printf("head or content is NULL!\n");
+my_sll* sll_get_last(my_sll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
         return NULL;
     }
+    return list->tail;
+}
 
-    my_sll* cur = head;
-
-    // go to the last node.
-    while (cur->next_ptr != NULL) {
-        cur = cur->next_ptr;
+/**
+ * @brief write all nodes and their contents, in the format of
+ * sll_print, through a buffered writer (list_writer.h). The text is
+ * handed to the output when the buffer is full or the writer released.
+ * 
+ * @param list 
+ * @param writer 
+ * @return list_status LIST_ERR_IO when writing failed.
+ */
+list_status sll_write(my_sll_list* list, list_writer* writer) {
+    if (writer == NULL) {
+        LOG_ERROR("writer is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list == NULL || list->head == NULL) {
+        list_writer_string(writer, "list is empty!\n");
+        return writer->failed ? LIST_ERR_IO : LIST_OK;
     }
 
-    // make a new node & append to the end.
-    my_sll* new_sll = malloc(sizeof(my_sll));
-    new_sll-> next_ptr = NULL;
-    new_sll-> content = content;
-    cur->next_ptr = new_sll;
-    return head;
+    size_t count = 1;
+    list_writer_string(writer, "*** list:\n");
+    for (my_sll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        list_writer_node(writer, count++, cur->content);
+    }
+    list_writer_string(writer, "*** size=");
+    list_writer_number(writer, list->count);
+    list_writer_text(writer, "\n", 1);
+    return writer->failed ? LIST_ERR_IO : LIST_OK;
 }
 
 /**
  * @brief print all nodes and their contents.
  * 
- * @param head 
+ * @param list 
  */
-void sll_print(my_sll *head) {
-    if (head == NULL) {
-        printf("head is NULL!\n");
-    }
-    
-    my_sll* cur = head;
-    int count = 1;
-    printf("*** list:\n");
-    do {
-        printf("%d. %s\n", count, cur->content->text);
-        cur = cur->next_ptr;
-        count++;
-    } while (cur != NULL);
-    printf("*** size=%d\n", count-1);
+void sll_print(my_sll_list *list) {
+    list_writer writer;
+    list_writer_init_file(&writer, stdout, LIST_COLOR_AUTO);
+    sll_write(list, &writer);
+    list_writer_release(&writer);
 }
 
 /**
- * @brief search for a node with given content.
+ * @brief search for a node with given content. With an index attached
+ * this is a hash lookup; among several nodes with the same text it
+ * returns one of them, not necessarily the first.
  * 
- * @cond neither head nor content should be NULL.
+ * @cond neither list nor content should be NULL.
  * 
- * @param head 
+ * @param list 
  * @param content 
  * @return my_sll* 
  */
-my_sll* sll_search(my_sll* head, my_content* content) {
-    if (head == NULL || content == NULL) {
-        printf("head or content is NULL!\n");
+my_sll* sll_search(my_sll_list* list, my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list or content is NULL!\n");
         return NULL;
     }
 
-    printf("** searching for %s\n", content->text);
-    my_sll* cur = head;
-    do {
-        if (strcmp(cur->content->text, content->text) == 0) {            
-            return cur;
+    LOG_DEBUG("** searching for %s\n", content->text);
+    LIST_TRACE_OP(LIST_TRACE_SEARCH, list->count);
+    LIST_STATS_ADD(searches, 1);
+    if (list->index != NULL) {
+        list_index_entry* entry = list_index_find(list->index, content);
+        return entry != NULL ? entry->node : NULL;
+    }
+
+    size_t visits = 0;
+    my_sll* cur = list->head;
+    while (cur != NULL) {
+        visits++;
+        if (content_equals(cur->content, content)) {            
+            break;
         }
         cur = cur->next_ptr;
-    } while (cur != NULL);
-    return NULL;
+    }
+    LIST_STATS_ADD(search_visits, visits);
+    return cur;
 }
 
 /**
- * @brief inserting a node infront of a node pointed by `at`.
+ * @brief linking a node right after `after`, without checks or tracing.
+ * 
+ */
+static void sll_link_after(my_sll_list* list, my_sll* after, my_sll* node) {
+    // after ---> next
+    // after ---> new ---> next
+    node->next_ptr = after->next_ptr;
+    after->next_ptr = node;
+    if (list->tail == after) {
+        list->tail = node;
+    }
+    list->count++;
+    if (list->index != NULL) {
+        list_index_add(list->index, node, node->content);
+    }
+}
+
+/**
+ * @brief inserting a given node right after the node `after`. Nothing
+ * is searched, so this is a constant time operation.
+ * 
+ * @cond list, after, and node cannot be NULL. after must be in the list.
+ * 
+ * @param list 
+ * @param after 
+ * @param node 
+ * @return list_status 
+ */
+list_status sll_insert_after(my_sll_list* list, my_sll* after, my_sll* node) {
+    if (list == NULL || after == NULL || node == NULL) {
+        LOG_ERROR("list or after or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_INSERT, list->count);
+    sll_link_after(list, after, node);
+    return LIST_OK;
+}
+
+/**
+ * @brief unlinking the first node, without checks or tracing. The list
+ * must not be empty.
+ * 
+ */
+static my_sll* sll_unlink_front(my_sll_list* list) {
+    my_sll* node = list->head;
+    list->head = node->next_ptr;
+    if (list->tail == node) {
+        list->tail = NULL;
+    }
+    list->count--;
+    if (list->index != NULL) {
+        list_index_remove(list->index, node, node->content);
+    }
+    return node;
+}
+
+/**
+ * @brief unlinking the node after `after`, without checks or tracing.
+ * 
+ */
+static my_sll* sll_unlink_after(my_sll_list* list, my_sll* after) {
+    my_sll* node = after->next_ptr;
+    if (node == NULL) {
+        return NULL;
+    }
+    after->next_ptr = node->next_ptr;
+    if (list->tail == node) {
+        list->tail = after;
+    }
+    list->count--;
+    if (list->index != NULL) {
+        list_index_remove(list->index, node, node->content);
+    }
+    return node;
+}
+
+/**
+ * @brief removing the node right after the node `after` from the list,
+ * in constant time. It is not freeing the node.
  * 
- * @cond head, at, and content cannot be NULL.
+ * @cond after must be in the list.
  * 
- * @param head 
+ * @param list 
+ * @param after 
+ * @return my_sll* the removed node, NULL when after is the last node.
+ */
+my_sll* sll_remove_after(my_sll_list* list, my_sll* after) {
+    if (list == NULL || after == NULL) {
+        LOG_ERROR("list or after is NULL!\n");
+        return NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_REMOVE, list->count);
+    return sll_unlink_after(list, after);
+}
+
+/**
+ * @brief inserting a given node infront of a node pointed by `at`.
+ * When `at` is not in the list, the node is not linked and stays
+ * with the caller.
+ * 
+ * @cond list, at, and node cannot be NULL.
+ * 
+ * @param list 
  * @param at 
- * @param content 
- * @return my_sll* 
+ * @param node 
+ * @return list_status 
  */
-my_sll* sll_insert(my_sll* head, my_sll* at, my_content* content) {
+list_status sll_insert_node(my_sll_list* list, my_sll* at, my_sll* node) {
 
-    if (head == NULL || at == NULL || content == NULL) {
-        printf("head or at or content is NULL!\n");
-        return head;
+    if (list == NULL || at == NULL || node == NULL) {
+        LOG_ERROR("list or at or node is NULL!\n");
+        return LIST_ERR_NULL;
     }
     
-    printf("inserting node ... %s at %s\n", content->text, at->content->text);
-    my_sll* cur = head;
+    LOG_DEBUG("inserting node ... %s at %s\n", node->content->text, at->content->text);
+    LIST_TRACE_OP(LIST_TRACE_INSERT, list->count);
+    LIST_STATS_ADD(inserts, 1);
+    my_sll* cur = list->head;
 
-    printf("inserting at the head?\n");
+    LOG_DEBUG("inserting at the head?\n");
     // Insert at the head
-    if (at == head) {
-        printf("inserting @ head ...\n");
-        head = malloc(sizeof(my_sll));
-        head->content = content;
-        head->next_ptr = cur;
-        return head;
+    if (at == list->head) {
+        LOG_DEBUG("inserting @ head ...\n");
+        sll_link_front(list, node);
+        return LIST_OK;
     }
 
     // Insert in the middle
-    printf("looking for the 'before' node\n");
+    LOG_DEBUG("looking for the 'before' node\n");
+    size_t visits = 0;
     do {
+        visits++;
         if (cur->next_ptr == at) {
-            printf("found node before '%s'\n", cur->content->text);
+            LOG_DEBUG("found node before '%s'\n", cur->content->text);
             break;
         }
         cur = cur->next_ptr;
     } while (cur != NULL);
+    LIST_STATS_ADD(insert_visits, visits);
 
-    printf("found it?\n");
+    LOG_DEBUG("found it?\n");
     // cannot locate the node before at
     if (cur == NULL) {
-        return head;
+        return LIST_ERR_NOT_FOUND;
     }
 
-    printf("inserting and return ...\n");
+    LOG_DEBUG("inserting and return ...\n");
     // located the node before at. now insert the node in front of at.
     // cur ---> at
     // cur ---> new ---> at;
-    my_sll *new = malloc(sizeof(my_sll));
-    new->content = content;
-    new->next_ptr = at;
-    cur->next_ptr = new;
-
-    // printf("cur %s\n", cur->content->text);
-    // printf("new %s\n", new->content->text);
-    // printf("at %s\n", at->content->text);
-    return head;
+    sll_link_after(list, cur, node);
+    return LIST_OK;
 }
 
 /**
- * @brief making the content with a given text.
+ * @brief inserting a node infront of a node pointed by `at`.
  * 
- * @cond text cannot be NULL
+ * @cond list, at, and content cannot be NULL.
  * 
- * @param text 
- * @return my_content* 
+ * @param list 
+ * @param at 
+ * @param content 
+ * @return list_status 
  */
-my_content* content_make(char* text) {
-    if (text == NULL) {
-        printf("text is NULL!\n");
-        return NULL;
-    }
-
-    my_content* content = malloc(sizeof(my_content));
-    content->text = malloc(strlen(text)+1);
-    strcpy(content->text, text);
-    return content;
-}
+list_status sll_insert(my_sll_list* list, my_sll* at, my_content* content) {
 
-my_content* content_free(my_content* content) {
-    if (content == NULL) {
-        printf("content is NULL!\n");
-        return content;
+    if (list == NULL || at == NULL || content == NULL) {
+        LOG_ERROR("list or at or content is NULL!\n");
+        return LIST_ERR_NULL;
     }
 
-    printf("freeing content node ...\n");
-    if (content->text != NULL) {
-        free(content->text);
+    my_sll* node = sll_make_node(list, content);
+    list_status status = sll_insert_node(list, at, node);
+    if (status != LIST_OK) {
+        // `at` is not in the list, the content stays with the caller.
+        sll_release_node(list, node);
     }
-    free(content);
-    return NULL;
+    return status;
 }
 
-void sll_free_node(my_sll* node) {
+/**
+ * @brief freeing a node removed from the list, along with its content.
+ * 
+ * @param list the list the node was made for.
+ * @param node 
+ */
+void sll_free_node(my_sll_list* list, my_sll* node) {
     if (node == NULL) {
-        printf("node is NULL!\n");
+        LOG_ERROR("node is NULL!\n");
         return;
     }
 
-    printf("freeing sll node ...\n");
-    content_free(node->content);
-    free(node);
+    LOG_DEBUG("freeing sll node ...\n");
+    if (!sll_node_embeds_content(node) && !(list != NULL && list_file_owns(list->file, node->content))) {
+        content_free(node->content);
+    }
+    sll_release_node(list, node);
 }
 
 /**
  * @brief remove a node from a list. it is not freeing the node.
  * 
- * @cond head or at cannot be NULL
+ * @cond list or at cannot be NULL
  * 
- * @param head 
+ * @param list 
  * @param at 
- * @return my_sll* 
+ * @return list_status 
  */
-my_sll* sll_remove_node(my_sll* head, my_sll* at) {
-    if (head == NULL || at == NULL) {
-        return head;
+list_status sll_remove_node(my_sll_list* list, my_sll* at) {
+    if (list == NULL || at == NULL) {
+        LOG_ERROR("list or at is NULL!\n");
+        return LIST_ERR_NULL;
     }
+    if (list->head == NULL) {
+        return LIST_ERR_NOT_FOUND;
+    }
+    LIST_TRACE_OP(LIST_TRACE_REMOVE, list->count);
+    LIST_STATS_ADD(removes, 1);
 
     // remove the head
-    if (head == at) {        
-        head = head->next_ptr;
-        return head;
+    if (list->head == at) {        
+        sll_unlink_front(list);
+        return LIST_OK;
     }
 
-    my_sll* cur = head;
+    my_sll* cur = list->head;
 
     // remove in the middle
-    printf("looking for the 'before' node\n");
+    LOG_DEBUG("looking for the 'before' node\n");
+    size_t visits = 0;
     do {
+        visits++;
         if (cur->next_ptr == at) {
-            printf("found node before '%s'\n", cur->content->text);
+            LOG_DEBUG("found node before '%s'\n", cur->content->text);
             break;
         }
         cur = cur->next_ptr;
     } while (cur != NULL);
+    LIST_STATS_ADD(remove_visits, visits);
 
-    printf("found it?\n");
-    if (cur != NULL) {
-        cur->next_ptr = at->next_ptr;
+    LOG_DEBUG("found it?\n");
+    if (cur == NULL) {
+        return LIST_ERR_NOT_FOUND;
     }
 
-    return head;
+    sll_unlink_after(list, cur);
+    return LIST_OK;
 }
 
 /**
- * @brief remove all nodes and free node along with the content.
+ * @brief A position in the list while walking it. The cursor keeps the
+ * node before the current one, so inserting in front of the current
+ * node and removing it take constant time: changing a list in one pass
+ * is O(n) instead of O(n^2) with sll_insert_node / sll_remove_node.
  * 
- * @cond head cannot be NULL!
+ * A cursor stays valid across its own changes. Changing the list by
+ * other means invalidates it.
  * 
- * @param head 
  */
-void sll_remove_all(my_sll* head) {
-    if (head == NULL) {
-        printf ("head is NULL!\n");
-        return;
+typedef struct sll_cursor {
+    my_sll_list* list;
+    my_sll* prev;       // NULL at the head
+    my_sll* cur;        // NULL past the last node
+} sll_cursor;
+
+/**
+ * @brief a cursor on the first node of the list.
+ * 
+ * @param list 
+ * @return sll_cursor 
+ */
+sll_cursor sll_cursor_begin(my_sll_list* list) {
+    sll_cursor cursor = { list, NULL, list != NULL ? list->head : NULL };
+    return cursor;
+}
+
+/**
+ * @brief the current node, NULL past the last node.
+ * 
+ * @param cursor 
+ * @return my_sll* 
+ */
+my_sll* sll_cursor_get(const sll_cursor* cursor) {
+    return cursor->cur;
+}
+
+/**
+ * @brief moving the cursor to the next node.
+ * 
+ * @param cursor 
+ * @return my_sll* the new current node, NULL past the last node.
+ */
+my_sll* sll_cursor_next(sll_cursor* cursor) {
+    if (cursor->cur != NULL) {
+        cursor->prev = cursor->cur;
+        cursor->cur = cursor->cur->next_ptr;
     }
-    printf ("removing all nodes ...\n");
-    my_sll* cur = head;
-    do {
+    return cursor->cur;
+}
+
+/**
+ * @brief inserting a node in front of the current node (at the end of
+ * the list when the cursor is past the last node). The cursor stays on
+ * the current node.
+ * 
+ * @param cursor 
+ * @param node 
+ * @return list_status 
+ */
+list_status sll_cursor_insert(sll_cursor* cursor, my_sll* node) {
+    if (cursor->list == NULL || node == NULL) {
+        LOG_ERROR("list or node is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_INSERT, cursor->list->count);
+    if (cursor->prev == NULL) {
+        sll_link_front(cursor->list, node);
+    } else {
+        sll_link_after(cursor->list, cursor->prev, node);
+    }
+    cursor->prev = node;
+    return LIST_OK;
+}
+
+/**
+ * @brief removing the current node from the list (DONOT FREE THE NODE).
+ * The cursor moves on to the next node.
+ * 
+ * @param cursor 
+ * @return my_sll* the removed node, NULL past the last node.
+ */
+my_sll* sll_cursor_remove(sll_cursor* cursor) {
+    my_sll* node = cursor->cur;
+    if (cursor->list == NULL || node == NULL) {
+        return NULL;
+    }
+
+    LIST_TRACE_OP(LIST_TRACE_REMOVE, cursor->list->count);
+    if (cursor->prev == NULL) {
+        sll_unlink_front(cursor->list);
+    } else {
+        sll_unlink_after(cursor->list, cursor->prev);
+    }
+    cursor->cur = cursor->prev == NULL ? cursor->list->head : cursor->prev->next_ptr;
+    return node;
+}
+
+/**
+ * @brief freeing every node, without checks or tracing, for sll_clear,
+ * sll_remove_all and the failure paths of the loaders.
+ * 
+ */
+static void sll_free_nodes(my_sll_list* list) {
+    my_sll* cur = list->head;
+    while (cur != NULL) {
         my_sll* free_sll = cur;
         cur = cur->next_ptr;
-        free(free_sll);
-    } while(cur != NULL);
+        sll_free_node(list, free_sll);
+    }
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+    list->arena = list_arena_free(list->arena);
+    list->file = list_file_unmap(list->file);
+    if (list->index != NULL) {
+        list_index_clear(list->index);
+    }
+}
+
+/**
+ * @brief remove and free all nodes along with their contents, leaving
+ * an empty list behind.
+ * 
+ * @cond list cannot be NULL!
+ * 
+ * @param list 
+ * @return list_status 
+ */
+list_status sll_clear(my_sll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    LIST_TRACE_OP(LIST_TRACE_REMOVE_ALL, list->count);
+    sll_free_nodes(list);
+    return LIST_OK;
+}
+
+/**
+ * @brief building a hash index over the contents of the list. From
+ * then on sll_search is O(1) on average and every operation that
+ * changes the list keeps the index up to date.
+ * 
+ * @param list 
+ * @return list_status 
+ */
+list_status sll_attach_index(my_sll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list->index != NULL) {
+        return LIST_OK;
+    }
+
+    list->index = list_index_make(list->count);
+    for (my_sll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        list_index_add(list->index, cur, cur->content);
+    }
+    return LIST_OK;
+}
+
+/**
+ * @brief dropping the hash index, sll_search walks the list again.
+ * 
+ * @param list 
+ * @return list_status 
+ */
+list_status sll_detach_index(my_sll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    list->index = list_index_free(list->index);
+    return LIST_OK;
+}
+
+/**
+ * @brief merging two sorted chains of nodes into one. On equal
+ * contents the node of `a` comes first, which keeps sorting stable.
+ * 
+ */
+static my_sll* sll_merge_runs(my_sll* a, my_sll* b, content_compare_fn compare) {
+    my_sll merged;
+    my_sll* tail = &merged;
+    while (a != NULL && b != NULL) {
+        if (compare(b->content, a->content) < 0) {
+            tail->next_ptr = b;
+            b = b->next_ptr;
+        } else {
+            tail->next_ptr = a;
+            a = a->next_ptr;
+        }
+        tail = tail->next_ptr;
+    }
+    tail->next_ptr = a != NULL ? a : b;
+    return merged.next_ptr;
+}
+
+#define SLL_SORT_BINS 64
+
+/**
+ * @brief sorting the list in place, stable and in O(n log n), by
+ * relinking its nodes: nothing is allocated or copied. Bottom-up merge
+ * sort: bin i holds a sorted run of 2^i nodes, and every node taken
+ * from the list is carried through the bins like a binary counter.
+ * 
+ * @param list 
+ * @param compare NULL for content_compare (strcmp order).
+ * @return list_status 
+ */
+list_status sll_sort(my_sll_list* list, content_compare_fn compare) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (compare == NULL) {
+        compare = content_compare;
+    }
+
+    my_sll* bins[SLL_SORT_BINS] = { NULL };
+    my_sll* cur = list->head;
+    while (cur != NULL) {
+        my_sll* run = cur;
+        cur = cur->next_ptr;
+        run->next_ptr = NULL;
+        size_t i = 0;
+        // the runs in the bins are older than the new one, they go first.
+        for (; i < SLL_SORT_BINS - 1 && bins[i] != NULL; i++) {
+            run = sll_merge_runs(bins[i], run, compare);
+            bins[i] = NULL;
+        }
+        bins[i] = sll_merge_runs(bins[i], run, compare);
+    }
+
+    my_sll* sorted = NULL;
+    for (size_t i = 0; i < SLL_SORT_BINS; i++) {
+        sorted = sll_merge_runs(bins[i], sorted, compare);
+    }
+    list->head = sorted;
+    while (sorted != NULL && sorted->next_ptr != NULL) {
+        sorted = sorted->next_ptr;
+    }
+    list->tail = sorted;
+    return LIST_OK;
+}
+
+/**
+ * @brief moving all nodes of `other` into the list, in order, in
+ * O(n + m). On equal contents the nodes of the list come first. The
+ * nodes of other's arena go along with them; other is left empty.
+ * 
+ * @cond both lists must be sorted with `compare` and take their nodes
+ * from the same pool (or none).
+ * 
+ * @param list 
+ * @param other 
+ * @param compare NULL for content_compare (strcmp order).
+ * @return list_status 
+ */
+list_status sll_merge(my_sll_list* list, my_sll_list* other, content_compare_fn compare) {
+    if (list == NULL || other == NULL) {
+        LOG_ERROR("list and/or other is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (list == other) {
+        return LIST_OK;
+    }
+    if (compare == NULL) {
+        compare = content_compare;
+    }
+
+    if (list->index != NULL) {
+        for (my_sll* cur = other->head; cur != NULL; cur = cur->next_ptr) {
+            list_index_add(list->index, cur, cur->content);
+        }
+    }
+    if (other->index != NULL) {
+        list_index_clear(other->index);
+    }
+
+    my_sll* tail = list->tail;
+    if (other->tail != NULL && (tail == NULL || compare(other->tail->content, tail->content) >= 0)) {
+        tail = other->tail;
+    }
+    list->head = sll_merge_runs(list->head, other->head, compare);
+    list->tail = tail;
+    list->count += other->count;
+    list->arena = list_arena_merge(list->arena, other->arena);
+    list->file = list_file_merge(list->file, other->file);
+
+    other->head = NULL;
+    other->tail = NULL;
+    other->count = 0;
+    other->arena = NULL;
+    other->file = NULL;
+    return LIST_OK;
+}
+
+/**
+ * @brief writing the contents of the list to a list file (list_file.h),
+ * in order.
+ * 
+ * @param list 
+ * @param path 
+ * @return list_status LIST_ERR_IO when the file cannot be written.
+ */
+list_status sll_save(my_sll_list* list, const char* path) {
+    if (list == NULL || path == NULL) {
+        LOG_ERROR("list and/or path is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    list_file_writer* writer = list_file_writer_open(path);
+    if (writer == NULL) {
+        return LIST_ERR_IO;
+    }
+    list_status status = LIST_OK;
+    for (my_sll* cur = list->head; cur != NULL && status == LIST_OK; cur = cur->next_ptr) {
+        status = list_file_write(writer, cur->content);
+    }
+    list_status closed = list_file_writer_close(writer);
+    return status != LIST_OK ? status : closed;
+}
+
+/**
+ * @brief making a list from a list file without copying any text: the
+ * file is mapped and the content of every node points into the
+ * mapping. The nodes come from one arena, like with sll_from_array.
+ * Every record is checked (bounds, '\0', hash) as its node is made,
+ * so the load reads the whole file: O(file size).
+ * 
+ * The contents are read-only. The list itself can be changed as usual;
+ * the mapping goes away with sll_clear / sll_remove_all.
+ * 
+ * @param path 
+ * @return my_sll_list* NULL when the file cannot be mapped or is
+ * damaged.
+ */
+my_sll_list* sll_load(const char* path) {
+    if (path == NULL) {
+        LOG_ERROR("path is NULL!\n");
+        return NULL;
+    }
+    list_file* file = list_file_map(path);
+    if (file == NULL) {
+        return NULL;
+    }
+
+    my_sll_list *list = malloc(sizeof(my_sll_list));
+    list->pool = NULL;
+    list->index = NULL;
+    list->arena = file->count > 0 ? list_arena_make(file->count * list_pool_align(sizeof(my_sll))) : NULL;
+    list->file = file;
+    list->head = NULL;
+    list->tail = NULL;
+    list->count = 0;
+
+    my_sll** link = &list->head;
+    for (uint64_t i = 0; i < file->count; i++) {
+        const my_content* content = list_file_content(file, i);
+        if (content == NULL) {
+            LOG_ERROR("record %llu of %s is damaged!\n", (unsigned long long)i, path);
+            sll_free_nodes(list);
+            free(list);
+            return NULL;
+        }
+        my_sll* node = list_arena_alloc(list->arena, sizeof(my_sll));
+        LIST_STATS_ADD(node_allocs, 1);
+        LIST_STATS_ADD(node_bytes, sizeof(my_sll));
+        node->content = (my_content*)content;
+        node->next_ptr = NULL;
+        *link = node;
+        link = &node->next_ptr;
+        list->tail = node;
+        list->count++;
+    }
+    return list;
+}
+
+/**
+ * @brief appending a line as a text node carved from the list's arena.
+ * 
+ */
+static list_status sll_append_line(my_sll_list* list, const char* text, size_t length) {
+    my_sll* node = list_arena_alloc(list->arena, sizeof(my_sll) + CONTENT_SIZE(length));
+    if (node == NULL) {
+        return LIST_ERR_NO_MEMORY;
+    }
+    LIST_STATS_ADD(node_allocs, 1);
+    LIST_STATS_ADD(node_bytes, sizeof(my_sll) + CONTENT_SIZE(length));
+    node->content = content_init(node + 1, text, length);
+    node->next_ptr = NULL;
+    if (list->tail == NULL) {
+        list->head = node;
+    } else {
+        list->tail->next_ptr = node;
+    }
+    list->tail = node;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief making a list with one node per line read from a file
+ * descriptor (a file, a pipe, stdin). The input is read in large
+ * chunks (list_stream.h); node and text of every line come from the
+ * list's arena, whose blocks double as it grows.
+ * 
+ * @param fd read until its end; it is not closed.
+ * @return my_sll_list* NULL when reading failed.
+ */
+my_sll_list* sll_from_stream(int fd) {
+    list_stream stream;
+    list_stream_init(&stream, fd, 0);
+    my_sll_list* list = sll_from_array(NULL, 0);
+    list->arena = list_arena_make(0);
+
+    const char* line;
+    size_t length;
+    list_status status = LIST_OK;
+    while (status == LIST_OK && list_stream_next_line(&stream, &line, &length)) {
+        status = sll_append_line(list, line, length);
+    }
+    bool failed = stream.failed || status != LIST_OK;
+    list_stream_release(&stream);
+    if (failed) {
+        sll_free_nodes(list);
+        free(list);
+        return NULL;
+    }
+    return list;
+}
+
+/**
+ * @brief handing the lines of a file descriptor to `batch` in lists of
+ * up to `batch_lines` nodes, so that an input larger than memory can be
+ * processed: only one batch is in memory at a time. The batch list and
+ * its contents are freed after the callback returns; a callback that
+ * wants to keep a text must copy it.
+ * 
+ * @param fd read until its end; it is not closed.
+ * @param batch_lines lines per batch, at least 1.
+ * @param batch called for every batch; returning anything but LIST_OK
+ * (LIST_STOP to just stop early) stops the reading and is returned.
+ * @param context passed to batch.
+ * @return list_status LIST_ERR_IO when reading failed.
+ */
+list_status sll_stream_batches(int fd, size_t batch_lines, list_status (*batch)(my_sll_list* list, void* context),
+        void* context) {
+    if (batch == NULL || batch_lines == 0) {
+        LOG_ERROR("batch is NULL or batch_lines is 0!\n");
+        return LIST_ERR_NULL;
+    }
+
+    list_stream stream;
+    list_stream_init(&stream, fd, 0);
+    my_sll_list* list = sll_from_array(NULL, 0);
+    const char* line;
+    size_t length;
+    list_status status = LIST_OK;
+    while (status == LIST_OK) {
+        list->arena = list_arena_make(0);
+        while (status == LIST_OK && list->count < batch_lines && list_stream_next_line(&stream, &line, &length)) {
+            status = sll_append_line(list, line, length);
+        }
+        if (stream.failed) {
+            status = LIST_ERR_IO;
+        }
+        bool more = list->count == batch_lines;
+        if (status == LIST_OK && list->count > 0) {
+            status = batch(list, context);
+        }
+        sll_free_nodes(list);
+        if (!more) {
+            break;
+        }
+    }
+    list_stream_release(&stream);
+    free(list);
+    return status;
+}
+
+/**
+ * @brief remove all nodes and free node along with the content.
+ * The list handle itself is freed as well.
+ * 
+ * @cond list cannot be NULL!
+ * 
+ * @param list 
+ */
+void sll_remove_all(my_sll_list* list) {
+    if (list == NULL) {
+        LOG_ERROR("list is NULL!\n");
+        return;
+    }
+    LOG_DEBUG("removing all nodes ...\n");
+    LIST_TRACE_OP(LIST_TRACE_REMOVE_ALL, list->count);
+    sll_free_nodes(list);
+    list_index_free(list->index);
+    free(list);
 }
 
 /**
  * @brief Testing code starts here ...
+ * Define SLL_NO_MAIN to use the functions above from another program.
  * 
  */
+#ifndef SLL_NO_MAIN
 
-my_sll* test_make_sll(my_content* content) {
+my_sll_list* test_make_sll(my_content* content) {
     // creat a list with 1 node
     printf(">>> 1. making list <<<\n\n");
-    my_sll *head = sll_make(content);
-    printf("text= %s\n", head->content->text);
-    printf("size= %d\n", sll_count(head));
-    return head;
+    my_sll_list *list = sll_make(content);
+    printf("text= %s\n", list->head->content->text);
+    printf("size= %zu\n", sll_count(list));
+    return list;
+}
+
+void test_pooled_sll() {
+    printf(">>> 7. pooled list <<<\n\n");
+    list_pool* pool = list_pool_make(sizeof(my_sll), 2);
+    my_sll_list* list = sll_make_with_pool(pool, content_make("*** 1.0 ***"));
+    sll_append(list, content_make("*** 2.0 ***"));
+    sll_append(list, content_make("*** 3.0 ***"));
+    sll_print(list);
+
+    list_pool_stats stats = list_pool_get_stats(pool);
+    printf("blocks= %zu; live= %zu; recycled= %zu\n",
+        stats.blocks_allocated, stats.nodes_live, stats.nodes_recycled);
+    assert(stats.blocks_allocated == 2);
+    assert(stats.nodes_live == 3);
+    assert(stats.nodes_recycled == 0);
+
+    // a removed node goes back to the pool and is handed out again.
+    my_sll* at = list->head->next_ptr;
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    assert(list_pool_get_stats(pool).nodes_live == 2);
+
+    sll_append(list, content_make("*** 4.0 ***"));
+    assert(sll_get_last(list) == at);
+    stats = list_pool_get_stats(pool);
+    assert(stats.blocks_allocated == 2);
+    assert(stats.nodes_live == 3);
+    assert(stats.nodes_recycled == 1);
+    sll_print(list);
+
+    sll_remove_all(list);
+    assert(list_pool_get_stats(pool).nodes_live == 0);
+    pool = list_pool_free(pool);
+}
+
+void test_text_nodes() {
+    printf(">>> 8. text nodes <<<\n\n");
+    // without a pool, node and content come from one malloc.
+    my_sll_list* list = sll_make(content_make("*** 1.0 ***"));
+    sll_append_node(list, sll_make_text_node(list, "*** 2.0 ***"));
+    sll_prepend_node(list, sll_make_text_node(list, "*** 0.5 ***"));
+    assert(sll_node_embeds_content(list->head));
+    assert(!sll_node_embeds_content(list->head->next_ptr));
+    assert(list->head->content->length == strlen("*** 0.5 ***"));
+    sll_print(list);
+
+    my_content* search_content = content_make("*** 2.0 ***");
+    my_sll* at = sll_search(list, search_content);
+    assert(at != NULL && at == sll_get_last(list));
+    sll_insert_node(list, at, sll_make_text_node(list, "*** 1.5 ***"));
+    assert(sll_count(list) == 4);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    search_content = content_free(search_content);
+    sll_print(list);
+    sll_remove_all(list);
+
+    // small-string mode: texts up to 15 characters live in the pool node.
+    list_pool* pool = list_pool_make(SLL_SSO_NODE_SIZE(15), 0);
+    list = sll_make_with_pool(pool, content_make("*** 1.0 ***"));
+    sll_append_node(list, sll_make_text_node(list, "short"));
+    sll_append_node(list, sll_make_text_node(list, "a text that is too long to embed"));
+    assert(sll_node_embeds_content(list->head->next_ptr));
+    assert(!sll_node_embeds_content(sll_get_last(list)));
+    sll_print(list);
+
+    at = sll_get_last(list);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    at = sll_get_last(list);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    assert(sll_count(list) == 1);
+    sll_remove_all(list);
+    pool = list_pool_free(pool);
+}
+
+void test_indexed_search() {
+    printf(">>> 9. indexed search <<<\n\n");
+    my_sll_list* list = sll_make(content_make("*** 1.0 ***"));
+    sll_append(list, content_make("*** 2.0 ***"));
+    sll_append(list, content_make("*** 3.0 ***"));
+    sll_attach_index(list);
+    assert(list->index->count == 3);
+
+    my_content* search_content = content_make("*** 2.0 ***");
+    my_sll* at = sll_search(list, search_content);
+    assert(at == list->head->next_ptr);
+
+    // inserted and appended nodes are indexed, duplicates included.
+    sll_insert(list, at, content_make("*** 1.5 ***"));
+    sll_append(list, content_make("*** 2.0 ***"));
+    assert(list->index->count == sll_count(list));
+    list_index_entry* entry = list_index_find(list->index, search_content);
+    assert(entry != NULL);
+    entry = list_index_find_next(entry, search_content);
+    assert(entry != NULL);
+    assert(list_index_find_next(entry, search_content) == NULL);
+    sll_print(list);
+
+    // removed nodes are not found anymore.
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    at = sll_search(list, search_content);
+    assert(at == sll_get_last(list));
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    assert(sll_search(list, search_content) == NULL);
+    assert(list->index->count == sll_count(list));
+
+    my_content* head_content = content_make("*** 1.0 ***");
+    at = sll_search(list, head_content);
+    assert(at == list->head);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    assert(sll_search(list, head_content) == NULL);
+    content_free(head_content);
+
+    sll_clear(list);
+    assert(list->index->count == 0);
+    sll_append(list, content_make("*** 2.0 ***"));
+    assert(sll_search(list, search_content) == list->head);
+
+    sll_detach_index(list);
+    assert(list->index == NULL);
+    assert(sll_search(list, search_content) == list->head);
+    content_free(search_content);
+    sll_remove_all(list);
+}
+
+void test_status_codes() {
+    printf(">>> 10. status codes <<<\n\n");
+    my_sll_list* list = sll_make(content_make("*** 1.0 ***"));
+    my_content* content = content_make("*** 2.0 ***");
+    list_status status = sll_append(list, content);
+    assert(status == LIST_OK);
+    status = sll_append(NULL, content);
+    assert(status == LIST_ERR_NULL);
+    status = sll_append(list, NULL);
+    assert(status == LIST_ERR_NULL);
+    status = sll_prepend_node(list, NULL);
+    assert(status == LIST_ERR_NULL);
+
+    // a node that is not in the list is reported, not linked.
+    my_sll* stray = sll_make_text_node(list, "*** stray ***");
+    content = content_make("*** 1.5 ***");
+    status = sll_insert(list, stray, content);
+    assert(status == LIST_ERR_NOT_FOUND);
+    status = sll_remove_node(list, stray);
+    assert(status == LIST_ERR_NOT_FOUND);
+    assert(sll_count(list) == 2);
+    content_free(content);
+    sll_free_node(list, stray);
+
+    my_sll* last = sll_get_last(list);
+    status = sll_remove_node(list, last);
+    assert(status == LIST_OK);
+    sll_free_node(list, last);
+    printf("status= %s\n", list_status_name(sll_clear(list)));
+    assert(sll_count(list) == 0);
+    sll_remove_all(list);
+}
+
+void test_from_array() {
+    printf(">>> 11. list from an array <<<\n\n");
+    const char* texts[] = { "*** 1.0 ***", "*** 2.0 ***", "*** 3.0 ***", "*** 4.0 ***" };
+    my_sll_list* list = sll_from_array(texts, 4);
+    assert(sll_count(list) == 4);
+    assert(strcmp(list->head->content->text, "*** 1.0 ***") == 0);
+    assert(strcmp(sll_get_last(list)->content->text, "*** 4.0 ***") == 0);
+    assert(sll_node_embeds_content(list->head));
+    assert(list_arena_owns(list->arena, list->head->next_ptr));
+    sll_print(list);
+
+    // arena nodes and malloc'ed nodes can be mixed and removed freely.
+    sll_append(list, content_make("*** 5.0 ***"));
+    assert(!list_arena_owns(list->arena, sll_get_last(list)));
+    my_content* search_content = content_make("*** 2.0 ***");
+    my_sll* at = sll_search(list, search_content);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    assert(sll_search(list, search_content) == NULL);
+    assert(sll_count(list) == 4);
+    content_free(search_content);
+    sll_print(list);
+
+    sll_clear(list);
+    assert(list->arena == NULL);
+    sll_remove_all(list);
+
+    list = sll_from_array(NULL, 0);
+    assert(sll_count(list) == 0 && list->head == NULL);
+    sll_append(list, content_make("*** 1.0 ***"));
+    assert(list->head == sll_get_last(list));
+    sll_remove_all(list);
+
+    const char* bad_texts[] = { "*** 1.0 ***", NULL };
+    list = sll_from_array(bad_texts, 2);
+    assert(list == NULL);
+}
+
+/**
+ * @brief sorting by length, longest first; equal lengths keep their
+ * order.
+ * 
+ */
+int test_longer_first(const my_content* c1, const my_content* c2) {
+    return (c1->length < c2->length) - (c1->length > c2->length);
+}
+
+void test_sort_and_merge() {
+    printf(">>> 12. sorting and merging lists <<<\n\n");
+    const char* texts[] = { "pear", "fig", "apple", "kiwi", "banana", "fig" };
+    my_sll_list* list = sll_from_array(texts, 6);
+    my_sll* first_fig = list->head->next_ptr;
+    list_status status = sll_sort(list, NULL);
+    assert(status == LIST_OK);
+    sll_print(list);
+    const char* sorted[] = { "apple", "banana", "fig", "fig", "kiwi", "pear" };
+    size_t i = 0;
+    for (my_sll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        assert(strcmp(cur->content->text, sorted[i++]) == 0);
+    }
+    assert(i == 6 && sll_count(list) == 6);
+    assert(list->head->next_ptr->next_ptr == first_fig);
+    assert(strcmp(sll_get_last(list)->content->text, "pear") == 0);
+
+    // a comparator of our own; the sort is stable.
+    status = sll_sort(list, test_longer_first);
+    assert(status == LIST_OK);
+    sll_print(list);
+    assert(strcmp(list->head->content->text, "banana") == 0);
+    assert(strcmp(list->head->next_ptr->content->text, "apple") == 0);
+    assert(strcmp(sll_get_last(list)->content->text, "fig") == 0);
+    sll_sort(list, NULL);
+
+    // merging moves the nodes, and the arena, of the other list.
+    const char* more_texts[] = { "cherry", "fig", "zucchini" };
+    my_sll_list* other = sll_from_array(more_texts, 3);
+    my_sll* other_fig = other->head->next_ptr;
+    sll_attach_index(list);
+    status = sll_merge(list, other, NULL);
+    assert(status == LIST_OK);
+    sll_print(list);
+    assert(sll_count(list) == 9 && sll_count(other) == 0 && other->head == NULL);
+    assert(strcmp(sll_get_last(list)->content->text, "zucchini") == 0);
+    assert(first_fig->next_ptr->next_ptr == other_fig);
+    assert(list_arena_owns(list->arena, other_fig) && other->arena == NULL);
+    my_content* search_content = content_make("cherry");
+    assert(sll_search(list, search_content) != NULL);
+    content_free(search_content);
+    for (my_sll* cur = list->head; cur->next_ptr != NULL; cur = cur->next_ptr) {
+        assert(content_compare(cur->content, cur->next_ptr->content) <= 0);
+    }
+
+    status = sll_sort(NULL, NULL);
+    assert(status == LIST_ERR_NULL);
+    status = sll_merge(list, NULL, NULL);
+    assert(status == LIST_ERR_NULL);
+    sll_remove_all(other);
+    sll_remove_all(list);
+}
+
+void test_save_and_load() {
+    printf(">>> 13. saving and loading a list file <<<\n\n");
+    char path[] = "/tmp/sll-file-XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    const char* texts[] = { "*** 1.0 ***", "", "*** a longer text of 3.0 ***" };
+    my_sll_list* list = sll_from_array(texts, 3);
+    sll_append(list, content_make("*** 4.0 ***"));
+    list_status status = sll_save(list, path);
+    assert(status == LIST_OK);
+
+    my_sll_list* loaded = sll_load(path);
+    assert(loaded != NULL && sll_count(loaded) == 4);
+    my_sll* cur = list->head;
+    for (my_sll* node = loaded->head; node != NULL; node = node->next_ptr) {
+        assert(content_equals(node->content, cur->content));
+        // the text is not copied, it is in the mapped file.
+        assert(list_file_owns(loaded->file, node->content->text));
+        cur = cur->next_ptr;
+    }
+    assert(strcmp(sll_get_last(loaded)->content->text, "*** 4.0 ***") == 0);
+    sll_print(loaded);
+
+    // the loaded list changes like any other.
+    my_content* search_content = content_make("");
+    my_sll* at = sll_search(loaded, search_content);
+    sll_remove_node(loaded, at);
+    sll_free_node(loaded, at);
+    sll_append(loaded, content_make("*** 5.0 ***"));
+    assert(sll_count(loaded) == 4);
+    content_free(search_content);
+    sll_remove_all(loaded);
+    sll_remove_all(list);
+
+    // an empty list, and files that are not list files.
+    my_sll_list* empty = sll_from_array(NULL, 0);
+    status = sll_save(empty, path);
+    assert(status == LIST_OK);
+    sll_remove_all(empty);
+    empty = sll_load(path);
+    assert(empty != NULL && sll_count(empty) == 0 && empty->head == NULL);
+    sll_remove_all(empty);
+
+    FILE* file = fopen(path, "wb");
+    fputs("not a list file, just text\n", file);
+    fclose(file);
+    empty = sll_load(path);
+    assert(empty == NULL);
+    unlink(path);
+    empty = sll_load(path);
+    assert(empty == NULL);
+    status = sll_save(NULL, path);
+    assert(status == LIST_ERR_NULL);
+}
+
+/**
+ * @brief counting the lines and batches handed over; stopping at the
+ * third batch when asked to.
+ * 
+ */
+typedef struct test_batch_counter {
+    size_t batches;
+    size_t lines;
+    size_t stop_at;
+} test_batch_counter;
+
+list_status test_count_batch(my_sll_list* list, void* context) {
+    test_batch_counter* counter = context;
+    counter->batches++;
+    counter->lines += sll_count(list);
+    assert(list_arena_owns(list->arena, list->head));
+    return counter->batches == counter->stop_at ? LIST_STOP : LIST_OK;
+}
+
+void test_from_stream() {
+    printf(">>> 14. reading a list from a stream <<<\n\n");
+    char path[] = "/tmp/sll-stream-XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    const char input[] = "*** 1.0 ***\n\n*** 3.0 ***\r\n*** a line longer than the chunk ***\n*** 5.0 ***";
+    ssize_t written = write(fd, input, sizeof(input) - 1);
+    assert(written == sizeof(input) - 1);
+
+    lseek(fd, 0, SEEK_SET);
+    my_sll_list* list = sll_from_stream(fd);
+    assert(list != NULL && sll_count(list) == 5);
+    sll_print(list);
+    assert(list->head->next_ptr->content->length == 0);
+    assert(strcmp(list->head->next_ptr->next_ptr->content->text, "*** 3.0 ***") == 0);
+    assert(strcmp(sll_get_last(list)->content->text, "*** 5.0 ***") == 0);
+    assert(list_arena_owns(list->arena, sll_get_last(list)));
+    sll_remove_all(list);
+
+    // lines cut by the end of tiny chunks come out whole.
+    lseek(fd, 0, SEEK_SET);
+    list_stream stream;
+    list_stream_init(&stream, fd, 4);
+    const char* line;
+    size_t length;
+    size_t lines = 0;
+    while (list_stream_next_line(&stream, &line, &length)) {
+        lines++;
+    }
+    assert(lines == 5 && !stream.failed);
+    assert(length == strlen("*** 5.0 ***") && memcmp(line, "*** 5.0 ***", length) == 0);
+    list_stream_release(&stream);
+
+    // batches of 2 lines; the callback can stop the reading.
+    lseek(fd, 0, SEEK_SET);
+    test_batch_counter counter = { 0, 0, 0 };
+    list_status status = sll_stream_batches(fd, 2, test_count_batch, &counter);
+    assert(status == LIST_OK);
+    assert(counter.batches == 3 && counter.lines == 5);
+    lseek(fd, 0, SEEK_SET);
+    counter = (test_batch_counter){ 0, 0, 2 };
+    status = sll_stream_batches(fd, 2, test_count_batch, &counter);
+    assert(status == LIST_STOP);
+    assert(counter.batches == 2 && counter.lines == 4);
+
+    close(fd);
+    unlink(path);
+    list = sll_from_stream(-1);
+    assert(list == NULL);
+    status = sll_stream_batches(-1, 2, test_count_batch, &counter);
+    assert(status == LIST_ERR_IO);
+    status = sll_stream_batches(-1, 0, test_count_batch, &counter);
+    assert(status == LIST_ERR_NULL);
+}
+
+void test_cursor() {
+    printf(">>> 15. editing a list while walking it <<<\n\n");
+    my_sll_list* list = sll_make(content_make("*** 1.0 ***"));
+    sll_attach_index(list);
+    my_sll* last = sll_make_node(list, content_make("*** 3.0 ***"));
+    list_status status = sll_insert_after(list, list->head, last);
+    assert(status == LIST_OK);
+    assert(sll_get_last(list) == last);
+    status = sll_insert_after(list, list->head, sll_make_node(list, content_make("*** 2.0 ***")));
+    assert(status == LIST_OK);
+    assert(sll_count(list) == 3 && list->head->next_ptr->next_ptr == last);
+
+    my_sll* removed = sll_remove_after(list, list->head->next_ptr);
+    assert(removed == last && sll_get_last(list) == list->head->next_ptr);
+    assert(sll_search(list, last->content) == NULL);
+    sll_free_node(list, removed);
+    removed = sll_remove_after(list, sll_get_last(list));
+    assert(removed == NULL);
+    status = sll_insert_after(list, NULL, last);
+    assert(status == LIST_ERR_NULL);
+
+    // 1.0 2.0 ... 6.0: drop the even nodes and put an x.5 node in
+    // front of the odd ones, in one pass.
+    char text[32];
+    for (int i = 3; i <= 6; i++) {
+        snprintf(text, sizeof(text), "*** %d.0 ***", i);
+        sll_append(list, content_make(text));
+    }
+    sll_cursor cursor = sll_cursor_begin(list);
+    for (int i = 1; sll_cursor_get(&cursor) != NULL; i++) {
+        if (i % 2 == 0) {
+            sll_free_node(list, sll_cursor_remove(&cursor));
+            continue;
+        }
+        snprintf(text, sizeof(text), "*** %d.5 ***", i - 1);
+        status = sll_cursor_insert(&cursor, sll_make_node(list, content_make(text)));
+        assert(status == LIST_OK);
+        sll_cursor_next(&cursor);
+    }
+    removed = sll_cursor_remove(&cursor);
+    my_sll* next = sll_cursor_next(&cursor);
+    assert(removed == NULL && next == NULL);
+    sll_print(list);
+
+    const char* expected[] = { "*** 0.5 ***", "*** 1.0 ***", "*** 2.5 ***", "*** 3.0 ***", "*** 4.5 ***", "*** 5.0 ***" };
+    assert(sll_count(list) == 6);
+    size_t i = 0;
+    for (my_sll* cur = list->head; cur != NULL; cur = cur->next_ptr) {
+        assert(strcmp(cur->content->text, expected[i++]) == 0);
+        assert(sll_search(list, cur->content) == cur);
+    }
+    assert(strcmp(sll_get_last(list)->content->text, "*** 5.0 ***") == 0);
+
+    // inserting past the last node appends; removing everything empties the list.
+    status = sll_cursor_insert(&cursor, sll_make_node(list, content_make("*** 6.0 ***")));
+    assert(status == LIST_OK);
+    assert(strcmp(sll_get_last(list)->content->text, "*** 6.0 ***") == 0);
+    cursor = sll_cursor_begin(list);
+    while (sll_cursor_get(&cursor) != NULL) {
+        sll_free_node(list, sll_cursor_remove(&cursor));
+    }
+    assert(sll_count(list) == 0 && list->head == NULL && sll_get_last(list) == NULL);
+    sll_remove_all(list);
+}
+
+void test_stats() {
+    printf(">>> 16. counting allocations and visited nodes <<<\n\n");
+    list_stats before = list_stats_snapshot();
+    my_sll_list* list = sll_make(content_make("*** 1.0 ***"));
+    sll_append(list, content_make("*** 2.0 ***"));
+    sll_append(list, content_make("*** 3.0 ***"));
+    my_content* search_content = content_make("*** 3.0 ***");
+    my_sll* at = sll_search(list, search_content);
+    sll_insert(list, at, content_make("*** 2.5 ***"));
+    content_free(search_content);
+    sll_remove_all(list);
+
+    list_stats stats = list_stats_snapshot();
+    list_stats_dump(stdout, &stats);
+    if (list_stats_enabled()) {
+        // everything made here is freed again, contents included.
+        assert(stats.content_allocs - before.content_allocs == 5);
+        assert(stats.content_frees - before.content_frees == 5);
+        assert(stats.node_allocs - before.node_allocs == 4);
+        assert(stats.node_frees - before.node_frees == 4);
+        assert(stats.searches - before.searches == 1);
+        assert(stats.search_visits - before.search_visits == 3);
+        assert(stats.inserts - before.inserts == 1);
+        assert(stats.insert_visits - before.insert_visits == 2);
+        list_stats_reset();
+        stats = list_stats_snapshot();
+        assert(stats.node_allocs == 0 && stats.search_visits == 0);
+    }
 }
 
 /**
@@ -336,6 +1742,16 @@ my_sll* test_make_sll(my_content* content) {
  * 4. insert nodes
  * 5. remove nodes
  * 6. free singly linked-list.
+ * 7. use a node pool for the list.
+ * 8. keep short texts inside the nodes.
+ * 9. search through a hash index.
+ * 10. report errors with status codes.
+ * 11. build a list from an array.
+ * 12. sort and merge lists.
+ * 13. save a list to a file and load it back without copying.
+ * 14. read a list from a stream of lines, whole or in batches.
+ * 15. insert and remove nodes in constant time while walking the list.
+ * 16. count allocations and visited nodes (build with -DLIST_STATS).
  * 
  * @param argv 
  * @return int 
@@ -344,23 +1760,24 @@ int main(int argc, char* argv[]) {
 
     // creat a list with 1 node
     printf(">>> 1. making list <<<\n\n");
-    my_sll *head = sll_make(content_make("*** 1.0 ***"));
-    printf("text= %s\n", head->content->text);
-    printf("size= %d\n", sll_count(head));
+    my_sll_list *list = sll_make(content_make("*** 1.0 ***"));
+    printf("text= %s\n", list->head->content->text);
+    printf("size= %zu\n", sll_count(list));
 
     // adding the contents ...
     printf(">>> 2. appending nodes <<<\n\n");
-    sll_append(head, content_make("*** 2.0 ***"));
-    sll_append(head, content_make("*** 3.0 ***"));
+    sll_append(list, content_make("*** 2.0 ***"));
+    sll_append(list, content_make("*** 3.0 ***"));
+    printf("last= %s\n", sll_get_last(list)->content->text);
 
     printf("\n\n");
-    sll_print(head);
-    printf("size= %d\n", sll_count(head));
+    sll_print(list);
+    printf("size= %zu\n", sll_count(list));
 
     // searching for 2
     printf(">>> 3. searching for nodes <<<\n\n");
     my_content* search_content = content_make("*** 2.0 ***");
-    my_sll* found_sll = sll_search(head, search_content);
+    my_sll* found_sll = sll_search(list, search_content);
     if (found_sll != NULL) {
         printf ("search=%s; found= %s\n", search_content->text, found_sll->content->text);
     }
@@ -369,66 +1786,98 @@ int main(int argc, char* argv[]) {
     printf("\n\n");
     search_content = content_free(search_content);
     search_content = content_make("*** 3.0 ***");
-    found_sll = sll_search(head, search_content);
+    found_sll = sll_search(list, search_content);
     if (found_sll != NULL) {
         printf ("search=%s; found= %s\n", search_content->text, found_sll->content->text);
     }
 
     printf(">>> 4. inserting nodes <<<\n\n");
     printf("before insert at 2.0...\n");
-    sll_print(head);
+    sll_print(list);
 
     // search for content 2, then insert at that node.  
     printf("\n\n");  
     search_content = content_free(search_content);
     search_content = content_make("*** 2.0 ***");
-    my_sll* at = sll_search(head, search_content);
+    my_sll* at = sll_search(list, search_content);
 
-    head = sll_insert(head, at, content_make("*** 1.5 ***"));
+    sll_insert(list, at, content_make("*** 1.5 ***"));
 
     printf("\n\n");
     printf("after insert at 2.0...\n");
-    sll_print(head);
+    sll_print(list);
 
     // search for content 3, then insert at that node.    
     printf("\n\n");
     search_content = content_free(search_content);
     search_content = content_make("*** 3.0 ***");
-    at = sll_search(head, search_content);
+    at = sll_search(list, search_content);
 
-    head = sll_insert(head, at, content_make("*** 2.5 ***"));
+    sll_insert(list, at, content_make("*** 2.5 ***"));
 
     printf("\n\n");
     printf("after insert at 3.0...\n");
-    sll_print(head);
+    sll_print(list);
 
     // insert at head.
     printf("\n\n");
-    head = sll_insert(head, head, content_make("*** 0.5 ***"));
+    sll_insert(list, list->head, content_make("*** 0.5 ***"));
     printf("\n\n");
     printf("after insert at head...\n");
-    sll_print(head);
+    sll_print(list);
+
+    // prepend and append in constant time.
+    printf("\n\n");
+    sll_prepend(list, content_make("*** 0.0 ***"));
+    sll_append(list, content_make("*** 4.0 ***"));
+    printf("after prepend 0.0 and append 4.0...\n");
+    sll_print(list);
+    printf("first= %s; last= %s\n", list->head->content->text, sll_get_last(list)->content->text);
 
     printf(">>> 5. removing nodes <<<\n\n");
     search_content = content_free(search_content);
     search_content = content_make("*** 0.5 ***");
-    at = sll_search(head, search_content);
-    head = sll_remove_node(head, at);
-    sll_print(head);
+    at = sll_search(list, search_content);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    sll_print(list);
 
     search_content = content_free(search_content);
     search_content = content_make("*** 2.5 ***");
-    at = sll_search(head, search_content);
-    head = sll_remove_node(head, at);
-    sll_print(head);
+    at = sll_search(list, search_content);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    sll_print(list);
 
     search_content = content_free(search_content);
     search_content = content_make("*** 1.5 ***");
-    at = sll_search(head, search_content);
-    head = sll_remove_node(head, at);
-    sll_print(head);
+    at = sll_search(list, search_content);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    sll_print(list);
+
+    // removing the last node moves the tail back.
+    search_content = content_free(search_content);
+    search_content = content_make("*** 4.0 ***");
+    at = sll_search(list, search_content);
+    sll_remove_node(list, at);
+    sll_free_node(list, at);
+    sll_print(list);
+    printf("last= %s\n", sll_get_last(list)->content->text);
 
     printf(">>> 6. freeing list <<<\n\n");
     search_content = content_free(search_content);
-    sll_remove_all(head);
-}
\ No newline at end of file
+    sll_remove_all(list);
+
+    test_pooled_sll();
+    test_text_nodes();
+    test_indexed_search();
+    test_status_codes();
+    test_from_array();
+    test_sort_and_merge();
+    test_save_and_load();
+    test_from_stream();
+    test_cursor();
+    test_stats();
+}
+#endif
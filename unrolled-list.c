@@ -0,0 +1,589 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "ansi_color_codes.h"
+#include "list_log.h"
+#include "my_content.h"
+#include "list_simd.h"
+
+/**
+ * @brief Example of an unrolled linked-list management.
+ * An unrolled linked-list is a doubly linked-list whose nodes (chunks)
+ * hold a small array of contents instead of a single one. Walking the
+ * list visits one chunk per ULL_CAPACITY contents, so traversals touch
+ * far fewer cache lines than a my_dll with one node per content.
+ *
+ * A full chunk is split in two when inserting into it. A chunk that
+ * drops below half full is merged with its next chunk when both fit
+ * into one.
+ *
+ * Every chunk also keeps the hashes of its contents in an array of
+ * their own. Searching compares a whole chunk of hashes with a few SIMD
+ * instructions (list_simd.h) and only reads the contents whose hash
+ * matches.
+ *
+ * @author Kiet T. Tran, Ph.D.
+ *
+ */
+
+#define ULL_CAPACITY 16
+
+/**
+ * @brief Data structures for the chunk, the list and a position in
+ * the list ...
+ *
+ */
+typedef struct my_ull {
+    struct my_ull* prev_ptr;
+    struct my_ull* next_ptr;
+    size_t used;
+    my_content* contents[ULL_CAPACITY];
+    uint64_t hashes[ULL_CAPACITY];      // contents[i]->hash
+} my_ull;
+
+typedef struct my_ull_list {
+    my_ull* head;
+    my_ull* tail;
+    size_t count;
+} my_ull_list;
+
+/**
+ * @brief A content is found at an index of a chunk. A position is
+ * valid until the list is changed.
+ *
+ */
+typedef struct my_ull_pos {
+    my_ull* chunk;
+    size_t index;
+} my_ull_pos;
+
+/**
+ * @brief Making an empty chunk.
+ *
+ * @return my_ull*
+ */
+my_ull* ull_make_chunk() {
+    my_ull* chunk = malloc(sizeof(my_ull));
+    chunk->prev_ptr = NULL;
+    chunk->next_ptr = NULL;
+    chunk->used = 0;
+    return chunk;
+}
+
+/**
+ * @brief Linking a new chunk right after a given one.
+ *
+ * @param list
+ * @param chunk
+ * @return my_ull* the new chunk
+ */
+my_ull* ull_add_chunk_after(my_ull_list* list, my_ull* chunk) {
+    my_ull* new_chunk = ull_make_chunk();
+    new_chunk->prev_ptr = chunk;
+    new_chunk->next_ptr = chunk->next_ptr;
+    if (chunk->next_ptr == NULL) {
+        list->tail = new_chunk;
+    } else {
+        chunk->next_ptr->prev_ptr = new_chunk;
+    }
+    chunk->next_ptr = new_chunk;
+    return new_chunk;
+}
+
+/**
+ * @brief Unlinking and freeing a chunk. Its contents are not touched.
+ *
+ * @param list
+ * @param chunk
+ */
+void ull_remove_chunk(my_ull_list* list, my_ull* chunk) {
+    if (chunk->prev_ptr == NULL) {
+        list->head = chunk->next_ptr;
+    } else {
+        chunk->prev_ptr->next_ptr = chunk->next_ptr;
+    }
+    if (chunk->next_ptr == NULL) {
+        list->tail = chunk->prev_ptr;
+    } else {
+        chunk->next_ptr->prev_ptr = chunk->prev_ptr;
+    }
+    free(chunk);
+}
+
+/**
+ * @brief Making the list with a given content.
+ *
+ * @cond content cannot be NULL
+ *
+ * @param content
+ * @return my_ull_list*
+ */
+my_ull_list* ull_make_list(my_content* content) {
+    if (content == NULL) {
+        LOG_ERROR("content is NULL!\n");
+        return NULL;
+    }
+
+    my_ull_list* list = malloc(sizeof(my_ull_list));
+    list->head = ull_make_chunk();
+    list->tail = list->head;
+    list->head->contents[0] = content;
+    list->head->hashes[0] = content->hash;
+    list->head->used = 1;
+    list->count = 1;
+    return list;
+}
+
+/**
+ * @brief Adding a content at the end of the list.
+ *
+ * @param list
+ * @param content
+ * @return list_status
+ */
+list_status ull_append(my_ull_list* list, my_content* content) {
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list and/or content is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+
+    if (list->tail == NULL) {
+        list->head = ull_make_chunk();
+        list->tail = list->head;
+    } else if (list->tail->used == ULL_CAPACITY) {
+        ull_add_chunk_after(list, list->tail);
+    }
+    list->tail->hashes[list->tail->used] = content->hash;
+    list->tail->contents[list->tail->used++] = content;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief Inserting a content in front of the content at a given
+ * position. A full chunk is split in two halves first.
+ *
+ * @param list
+ * @param at
+ * @param content
+ * @return list_status
+ */
+list_status ull_insert(my_ull_list* list, my_ull_pos at, my_content* content) {
+    if (list == NULL || at.chunk == NULL || content == NULL) {
+        LOG_ERROR("list or at or content is NULL!\n");
+        return LIST_ERR_NULL;
+    }
+    if (at.index > at.chunk->used) {
+        return LIST_ERR_NOT_FOUND;
+    }
+
+    my_ull* chunk = at.chunk;
+    size_t index = at.index;
+    if (chunk->used == ULL_CAPACITY) {
+        my_ull* new_chunk = ull_add_chunk_after(list, chunk);
+        size_t half = ULL_CAPACITY / 2;
+        memcpy(new_chunk->contents, chunk->contents + half, (ULL_CAPACITY - half) * sizeof(my_content*));
+        memcpy(new_chunk->hashes, chunk->hashes + half, (ULL_CAPACITY - half) * sizeof(uint64_t));
+        new_chunk->used = ULL_CAPACITY - half;
+        chunk->used = half;
+        if (index > half) {
+            chunk = new_chunk;
+            index -= half;
+        }
+    }
+
+    memmove(chunk->contents + index + 1, chunk->contents + index,
+        (chunk->used - index) * sizeof(my_content*));
+    memmove(chunk->hashes + index + 1, chunk->hashes + index, (chunk->used - index) * sizeof(uint64_t));
+    chunk->contents[index] = content;
+    chunk->hashes[index] = content->hash;
+    chunk->used++;
+    list->count++;
+    return LIST_OK;
+}
+
+/**
+ * @brief Removing the content at a given position from the list (DONOT
+ * FREE THE CONTENT). A chunk below half full is merged with the next
+ * chunk when both fit into one.
+ *
+ * @param list
+ * @param at
+ * @return my_content* the removed content
+ */
+my_content* ull_remove(my_ull_list* list, my_ull_pos at) {
+    if (list == NULL || at.chunk == NULL) {
+        LOG_ERROR("list and/or at is NULL!\n");
+        return NULL;
+    }
+    if (at.index >= at.chunk->used) {
+        return NULL;
+    }
+
+    my_ull* chunk = at.chunk;
+    my_content* content = chunk->contents[at.index];
+    chunk->used--;
+    memmove(chunk->contents + at.index, chunk->contents + at.index + 1,
+        (chunk->used - at.index) * sizeof(my_content*));
+    memmove(chunk->hashes + at.index, chunk->hashes + at.index + 1, (chunk->used - at.index) * sizeof(uint64_t));
+    list->count--;
+
+    if (chunk->used == 0) {
+        ull_remove_chunk(list, chunk);
+    } else if (chunk->used < ULL_CAPACITY / 2 && chunk->next_ptr != NULL
+            && chunk->used + chunk->next_ptr->used <= ULL_CAPACITY) {
+        my_ull* next = chunk->next_ptr;
+        memcpy(chunk->contents + chunk->used, next->contents, next->used * sizeof(my_content*));
+        memcpy(chunk->hashes + chunk->used, next->hashes, next->used * sizeof(uint64_t));
+        chunk->used += next->used;
+        ull_remove_chunk(list, next);
+    }
+    return content;
+}
+
+/**
+ * @brief Searching for a content. Returns a position with a NULL chunk
+ * when it is not found. The hashes of a chunk are compared first; a
+ * content is only read when its hash matches.
+ *
+ * @param list
+ * @param content
+ * @return my_ull_pos
+ */
+my_ull_pos ull_search(my_ull_list* list, my_content* content) {
+    my_ull_pos pos = {NULL, 0};
+    if (list == NULL || content == NULL) {
+        LOG_ERROR("list and/or content is NULL!\n");
+        return pos;
+    }
+
+    uint64_t hash = content->hash;
+    for (my_ull* chunk = list->head; chunk != NULL; chunk = chunk->next_ptr) {
+        size_t i = list_simd_find_hash(chunk->hashes, chunk->used, hash);
+        while (i < chunk->used) {
+            if (content_equals(chunk->contents[i], content)) {
+                pos.chunk = chunk;
+                pos.index = i;
+                return pos;
+            }
+            i += 1 + list_simd_find_hash(chunk->hashes + i + 1, chunk->used - i - 1, hash);
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief The content at a given position.
+ *
+ * @param at
+ * @return my_content*
+ */
+my_content* ull_get(my_ull_pos at) {
+    if (at.chunk == NULL || at.index >= at.chunk->used) {
+        return NULL;
+    }
+    return at.chunk->contents[at.index];
+}
+
+/**
+ * @brief getting the size of the list.
+ *
+ * @param list
+ * @return size_t
+ */
+size_t ull_size(my_ull_list* list) {
+    return list == NULL ? 0 : list->count;
+}
+
+/**
+ * @brief printing the contents of the list
+ *
+ * @param list
+ */
+void ull_print_list(my_ull_list* list) {
+    if (list == NULL || list->head == NULL) {
+        printf(">>> list is empty!\n");
+        return;
+    }
+
+    size_t node_no = 1;
+    for (my_ull* chunk = list->head; chunk != NULL; chunk = chunk->next_ptr) {
+        for (size_t i = 0; i < chunk->used; i++) {
+            printf("%zu. %s\n", node_no++, chunk->contents[i]->text);
+        }
+    }
+    printf(">>> list size: %zu\n", list->count);
+}
+
+/**
+ * @brief print the contents of the list in a reverse order, starting
+ * from the tail.
+ *
+ * @param list
+ */
+void ull_print_list_reverse(my_ull_list* list) {
+    if (list == NULL || list->head == NULL) {
+        printf("list is empty!\n");
+        return;
+    }
+
+    printf("%sprinting list in reverse order...%s\n", YEL, reset);
+    size_t count = list->count;
+    for (my_ull* chunk = list->tail; chunk != NULL; chunk = chunk->prev_ptr) {
+        for (size_t i = chunk->used; i > 0; i--) {
+            printf("%zu. %s\n", count--, chunk->contents[i - 1]->text);
+        }
+    }
+    printf(">>> list size: %zu\n", list->count);
+}
+
+/**
+ * @brief Removing all the contents and chunks of the list, and the list
+ * handle. return NULL when complete.
+ *
+ * @param list
+ * @return my_ull_list*
+ */
+my_ull_list* ull_remove_list(my_ull_list* list) {
+    if (list == NULL) {
+        return NULL;
+    }
+
+    my_ull* chunk = list->head;
+    while (chunk != NULL) {
+        my_ull* next = chunk->next_ptr;
+        for (size_t i = 0; i < chunk->used; i++) {
+            content_free(chunk->contents[i]);
+        }
+        free(chunk);
+        chunk = next;
+    }
+    free(list);
+    return NULL;
+}
+
+// ****** TEST CODE ****** //
+// Define ULL_NO_MAIN to use the functions above from another program.
+#ifndef ULL_NO_MAIN
+
+static size_t test_chunk_count(my_ull_list* list) {
+    size_t chunks = 0;
+    for (my_ull* chunk = list->head; chunk != NULL; chunk = chunk->next_ptr) {
+        chunks++;
+    }
+    return chunks;
+}
+
+static my_content* test_content(size_t i) {
+    char text[32];
+    snprintf(text, sizeof(text), "*** Node %zu ***", i);
+    return content_make(text);
+}
+
+void test_making_ull() {
+    printf("%s\ntest_making_ull%s\n", GRN, reset);
+    my_ull_list* list = ull_make_list(test_content(1));
+    assert(list != NULL);
+    assert(ull_size(list) == 1);
+    ull_print_list(list);
+
+    printf("*** making unrolled list incorrectly\n");
+    my_ull_list* bad = ull_make_list(NULL);
+    assert(bad == NULL);
+
+    list = ull_remove_list(list);
+    assert(list == NULL);
+    ull_print_list(list);
+}
+
+void test_appending_contents() {
+    printf("%s\ntest_appending_contents%s\n", GRN, reset);
+    my_ull_list* list = ull_make_list(test_content(0));
+    for (size_t i = 1; i < 2 * ULL_CAPACITY + 1; i++) {
+        ull_append(list, test_content(i));
+    }
+    assert(ull_size(list) == 2 * ULL_CAPACITY + 1);
+    assert(test_chunk_count(list) == 3);
+    ull_print_list(list);
+    ull_print_list_reverse(list);
+
+    printf("*** appending content incorrectly!\n");
+    list_status status = ull_append(list, NULL);
+    assert(status == LIST_ERR_NULL);
+    assert(ull_size(list) == 2 * ULL_CAPACITY + 1);
+    list = ull_remove_list(list);
+}
+
+void test_searching_contents() {
+    printf("%s\ntest_searching_contents%s\n", GRN, reset);
+    my_ull_list* list = ull_make_list(test_content(0));
+    for (size_t i = 1; i < 40; i++) {
+        ull_append(list, test_content(i));
+    }
+
+    my_content* search_content = test_content(20);
+    my_ull_pos at = ull_search(list, search_content);
+    assert(at.chunk == list->head->next_ptr && at.index == 20 - ULL_CAPACITY);
+    assert(content_equals(ull_get(at), search_content));
+    content_free(search_content);
+
+    search_content = test_content(40);
+    at = ull_search(list, search_content);
+    assert(at.chunk == NULL);
+    assert(ull_get(at) == NULL);
+    content_free(search_content);
+    list = ull_remove_list(list);
+}
+
+void test_inserting_contents() {
+    printf("%s\ntest_inserting_contents%s\n", GRN, reset);
+    printf("*** filling one chunk\n");
+    my_ull_list* list = ull_make_list(test_content(0));
+    for (size_t i = 1; i < ULL_CAPACITY; i++) {
+        ull_append(list, test_content(i * 10));
+    }
+    assert(test_chunk_count(list) == 1);
+
+    printf("*** inserting into a full chunk splits it\n");
+    my_content* search_content = test_content(120);
+    my_ull_pos at = ull_search(list, search_content);
+    ull_insert(list, at, test_content(115));
+    content_free(search_content);
+    assert(ull_size(list) == ULL_CAPACITY + 1);
+    assert(test_chunk_count(list) == 2);
+    assert(list->head->used == ULL_CAPACITY / 2);
+
+    search_content = test_content(115);
+    at = ull_search(list, search_content);
+    assert(at.chunk == list->tail);
+    my_content* next_content = test_content(120);
+    assert(content_equals(at.chunk->contents[at.index + 1], next_content));
+    content_free(next_content);
+    content_free(search_content);
+
+    printf("*** inserting @ head\n");
+    at.chunk = list->head;
+    at.index = 0;
+    ull_insert(list, at, test_content(5));
+    search_content = test_content(5);
+    assert(content_equals(list->head->contents[0], search_content));
+    content_free(search_content);
+    ull_print_list(list);
+    ull_print_list_reverse(list);
+
+    printf("*** inserting incorrectly\n");
+    at.chunk = NULL;
+    list_status status = ull_insert(list, at, NULL);
+    assert(status == LIST_ERR_NULL);
+    assert(ull_size(list) == ULL_CAPACITY + 2);
+    list = ull_remove_list(list);
+}
+
+void test_removing_contents() {
+    printf("%s\ntest_removing_contents%s\n", GRN, reset);
+    my_ull_list* list = ull_make_list(test_content(0));
+    for (size_t i = 1; i < 2 * ULL_CAPACITY; i++) {
+        ull_append(list, test_content(i));
+    }
+    assert(test_chunk_count(list) == 2);
+
+    printf("*** removing from the first chunk until it merges\n");
+    my_ull_pos at = {list->head, 0};
+    for (size_t i = 0; i < ULL_CAPACITY / 2 + 1; i++) {
+        content_free(ull_remove(list, at));
+    }
+    assert(ull_size(list) == 2 * ULL_CAPACITY - (ULL_CAPACITY / 2 + 1));
+    assert(test_chunk_count(list) == 2);
+
+    // the next chunk is still full, emptying half of it makes both fit.
+    for (size_t i = 0; i < ULL_CAPACITY / 2; i++) {
+        at.chunk = list->tail;
+        content_free(ull_remove(list, at));
+    }
+    assert(test_chunk_count(list) == 2);
+    at.chunk = list->head;
+    content_free(ull_remove(list, at));
+    assert(test_chunk_count(list) == 1);
+    assert(list->head == list->tail);
+    ull_print_list(list);
+
+    printf("*** removing everything leaves an empty list\n");
+    while (ull_size(list) > 0) {
+        at.chunk = list->tail;
+        at.index = list->tail->used - 1;
+        content_free(ull_remove(list, at));
+    }
+    assert(list->head == NULL && list->tail == NULL);
+    ull_print_list(list);
+
+    ull_append(list, test_content(1));
+    assert(ull_size(list) == 1 && list->head != NULL);
+    list = ull_remove_list(list);
+}
+
+void test_hash_search() {
+    printf("%s\ntest_hash_search%s\n", GRN, reset);
+    const char* name;
+    list_simd_select(&name);
+    printf("*** searching hashes with %s\n", name);
+
+    list_simd_find_fn finds[] = {
+        list_simd_find_hash_scalar,
+#ifdef LIST_SIMD_X86
+        list_simd_find_hash_sse2,
+        __builtin_cpu_supports("avx2") ? list_simd_find_hash_avx2 : list_simd_find_hash_scalar,
+#endif
+    };
+    uint64_t hashes[37];
+    for (size_t i = 0; i < 37; i++) {
+        // only one 32-bit half differs from the key, which SSE2 must not take for a match.
+        hashes[i] = 0x1234567800000000ULL | i;
+    }
+    for (size_t f = 0; f < sizeof(finds) / sizeof(finds[0]); f++) {
+        for (size_t count = 0; count <= 37; count++) {
+            for (size_t i = 0; i < count; i++) {
+                assert(finds[f](hashes, count, hashes[i]) == i);
+            }
+            assert(finds[f](hashes, count, 0x1234567800000000ULL | 99) == count);
+            assert(finds[f](hashes, count, 0x8765432100000005ULL) == count);
+        }
+    }
+
+    printf("*** a content with the same hash but another text is skipped\n");
+    my_ull_list* list = ull_make_list(test_content(0));
+    for (size_t i = 1; i < 40; i++) {
+        ull_append(list, test_content(i));
+    }
+    my_content* search_content = test_content(30);
+    my_ull_pos at = {list->head->next_ptr, 3};
+    my_content* twin = test_content(1000);
+    twin->hash = search_content->hash;
+    twin->length = search_content->length;
+    ull_insert(list, at, twin);
+    at = ull_search(list, search_content);
+    assert(content_equals(ull_get(at), search_content));
+    content_free(search_content);
+    list = ull_remove_list(list);
+}
+
+/**
+ * @brief running test code for using functions above.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char* argv[]) {
+    printf("%s---> STARTS!%s\n", RED, reset);
+    test_making_ull();
+    test_appending_contents();
+    test_searching_contents();
+    test_inserting_contents();
+    test_removing_contents();
+    test_hash_search();
+    printf("%s\n---> ENDS!%s\n", RED, reset);
+
+    return 0;
+}
+#endif